@@ -0,0 +1,158 @@
+/**
+ * @file    BandedLDLT.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File BandedLDLT.h contains the declaration &amp; definition of the BandedLDLT class template,
+ * which factors &amp; solves symmetric positive definite banded linear systems.
+ */
+
+#ifndef  BANDEDLDLT_H
+#define  BANDEDLDLT_H
+
+#include <cassert>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Dense>
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class template %BandedLDLT holds a symmetric positive definite banded matrix and its
+   * factors <em>L</em>&nbsp;<em>D</em>&nbsp;<em>L</em><sup>T</sup>, with <em>L</em> unit lower-triangular
+   * and <em>D</em> diagonal.
+   *
+   * A matrix of dimension <em>n</em>, with <em>kd</em> nonzero diagonals on each side of the main
+   * diagonal, is stored as its lower band alone, in (<em>kd</em>&nbsp;+&nbsp;1)&nbsp;<em>n</em> numbers;
+   * no pivoting is needed, so there is no fill-in.  Factoring costs
+   * O(<em>n</em>&nbsp;<em>kd</em><sup>&nbsp;2</sup>) operations, about half those of BandedLU on the
+   * same band, and each solve O(<em>n</em>&nbsp;<em>kd</em>) per right-hand side.\n
+   * <em>Scalar</em> is a real type, e.g. double.
+   */
+
+  template < typename Scalar >
+  class  BandedLDLT
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      typedef  Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>  Matrix ;
+      typedef  Eigen::Matrix<Scalar, Eigen::Dynamic, 1>               Vector ;
+
+      /** @brief An empty (0 by 0) matrix */
+      BandedLDLT ( ) : n ( 0 ), kd ( 0 ), factored ( false ) { }
+
+      /**
+        * @brief
+        * A zero matrix of dimension <em>n</em>, with <em>kd</em> diagonals on each side
+        */
+      BandedLDLT ( size_t n, size_t kd )
+        : n ( n ), kd ( kd ), band ( Matrix::Zero ( kd + 1, n ) ), factored ( false )
+        { }
+
+      /** @brief Dimension <em>n</em> */
+      size_t  size ( ) const  { return  n ; }
+
+      /**
+        * @brief
+        * Element (<em>i</em>,&nbsp;<em>j</em>), <em>j</em> &le; <em>i</em>, of the lower triangle,
+        * for assignment before <b><em>factorize</em></b>; it stands for element
+        * (<em>j</em>,&nbsp;<em>i</em>) too, and must lie within the band
+        */
+      Scalar &  coeffRef ( size_t i, size_t j )
+        {
+        assert ( ! factored ) ;
+        assert ( (i < n) && (j <= i) && (i <= j + kd) ) ;
+        return  band ( i - j, j ) ;
+        } // end coeffRef
+
+      /**
+        * @brief
+        * Replace the matrix by its factors
+        *
+        * @return  bool  false if the matrix is not (numerically) positive definite
+        */
+      bool  factorize ( )
+        {
+        assert ( ! factored ) ;
+        const Scalar  tolerance  =  ( kd + 1 ) * std::numeric_limits<Scalar>::epsilon() ;
+        for ( size_t j = 0 ; j < n ; j ++ )
+          {
+          size_t  first  =  ( j > kd ) ? ( j - kd ) : 0 ;
+          Scalar  diagonal  =  band ( 0, j ) ;
+          for ( size_t k = first ; k < j ; k ++ )
+            diagonal  -=  band ( j - k, k ) * band ( j - k, k ) * band ( 0, k ) ;
+          // A pivot lost to cancellation marks a singular (or indefinite) matrix.
+          if ( ! ( diagonal > tolerance * band ( 0, j ) ) )
+            return  false ;
+          band ( 0, j )  =  diagonal ;
+          size_t  last  =  std::min ( j + kd, n - 1 ) ;
+          for ( size_t i = j + 1 ; i <= last ; i ++ )
+            {
+            Scalar  sum  =  band ( i - j, j ) ;
+            for ( size_t k = ( (i > kd) ? (i - kd) : 0 ) ; k < j ; k ++ )
+              sum  -=  band ( i - k, k ) * band ( j - k, k ) * band ( 0, k ) ;
+            band ( i - j, j )  =  sum / diagonal ;
+            } // end for i loop
+          } // end for j loop
+        factored  =  true ;
+        return  true ;
+        } // end factorize
+
+      /**
+        * @brief
+        * Overwrite each column of <em>b</em> with the solution of&nbsp;
+        * <em>A</em>&nbsp;<em>x</em> = <em>b</em>; requires <b><em>factorize</em></b>
+        */
+      void  solveInPlace ( Eigen::Ref<Matrix> b ) const
+        {
+        assert ( factored && (static_cast<size_t>(b.rows()) == n) ) ;
+        // L:  forward substitution.
+        for ( size_t j = 0 ; j < n ; j ++ )
+          {
+          size_t  last  =  std::min ( j + kd, n - 1 ) ;
+          for ( size_t i = j + 1 ; i <= last ; i ++ )
+            b.row(i)  -=  band ( i - j, j ) * b.row(j) ;
+          } // end for j loop
+        // D
+        for ( size_t j = 0 ; j < n ; j ++ )
+          b.row(j)  /=  band ( 0, j ) ;
+        // L transposed:  back substitution.
+        for ( size_t j = n ; j -- > 0 ; )
+          {
+          size_t  last  =  std::min ( j + kd, n - 1 ) ;
+          for ( size_t i = j + 1 ; i <= last ; i ++ )
+            b.row(j)  -=  band ( i - j, j ) * b.row(i) ;
+          } // end for j loop
+        } // end solveInPlace
+
+      /**
+        * @brief
+        * Solution of&nbsp; <em>A</em>&nbsp;<em>x</em> = <em>b</em>; requires <b><em>factorize</em></b>
+        */
+      Vector  solve ( const Vector & b ) const
+        {
+        Vector  x  =  b ;
+        solveInPlace ( x ) ;
+        return  x ;
+        } // end solve
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      size_t  n ;
+      size_t  kd ;
+      Matrix  band ;      //  element (i,j), j <= i, at band ( i - j, j ); D on row 0 once factored
+      bool    factored ;
+
+    } ; // end BandedLDLT class template
+
+  } // end namespace BSCM
+
+#endif  //  BANDEDLDLT_H
@@ -0,0 +1,295 @@
+/**
+ * @file    BandedLU.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File BandedLU.h contains the declaration &amp; definition of the BandedLU class template,
+ * which factors &amp; solves banded linear systems.
+ */
+
+#ifndef  BANDEDLU_H
+#define  BANDEDLU_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Dense>
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class template %BandedLU holds a square banded matrix and its LU factors
+   * (with partial pivoting).
+   *
+   * A matrix of dimension <em>n</em>, with <em>kl</em> nonzero diagonals below the main diagonal
+   * and <em>ku</em> above it, is stored in (2&nbsp;<em>kl</em>&nbsp;+&nbsp;<em>ku</em>&nbsp;+&nbsp;1)&nbsp;<em>n</em>
+   * numbers; the extra <em>kl</em> diagonals receive the fill-in caused by row interchanges
+   * (the layout of LAPACK's <em>gbtrf</em>).  Factoring costs
+   * O(<em>n</em>&nbsp;<em>kl</em>&nbsp;(<em>kl</em>&nbsp;+&nbsp;<em>ku</em>)) operations, and each solve
+   * O(<em>n</em>&nbsp;(2&nbsp;<em>kl</em>&nbsp;+&nbsp;<em>ku</em>)) per right-hand side.
+   * <b><em>factorize</em></b> fails only on an exactly zero pivot; <b><em>rcond</em></b> then tells
+   * whether the matrix is singular to working precision.\n
+   * <em>Scalar</em> may be double or std::complex&lt;double&gt;.
+   */
+
+  template < typename Scalar >
+  class  BandedLU
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      typedef  Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>  Matrix ;
+      typedef  Eigen::Matrix<Scalar, Eigen::Dynamic, 1>               Vector ;
+      typedef  typename Eigen::NumTraits<Scalar>::Real                Real ;
+
+      /** @brief An empty (0 by 0) matrix */
+      BandedLU ( ) : n ( 0 ), kl ( 0 ), ku ( 0 ), scaledNorm ( 0 ), factored ( false ) { }
+
+      /**
+        * @brief
+        * A zero matrix of dimension <em>n</em>, with <em>kl</em> subdiagonals
+        * &amp; <em>ku</em> superdiagonals
+        */
+      BandedLU ( size_t n, size_t kl, size_t ku )
+        : n ( n ), kl ( kl ), ku ( ku ), band ( Matrix::Zero ( 2*kl + ku + 1, n ) ),
+          pivot ( n ), scaledNorm ( 0 ), factored ( false )
+        { }
+
+      /** @brief Dimension <em>n</em> */
+      size_t  size ( ) const  { return  n ; }
+
+      /**
+        * @brief
+        * Element (<em>i</em>,&nbsp;<em>j</em>) of the matrix, for assignment before
+        * <b><em>factorize</em></b>; must lie within the band
+        */
+      Scalar &  coeffRef ( size_t i, size_t j )
+        {
+        assert ( ! factored ) ;
+        assert ( (i < n) && (j < n) && (i <= j + kl) && (j <= i + ku) ) ;
+        return  band ( kl + ku + i - j, j ) ;
+        } // end coeffRef
+
+      /**
+        * @brief
+        * Replace the matrix by its LU factors, choosing the largest pivot in each column
+        *
+        * @return  bool  false if the matrix is singular
+        */
+      bool  factorize ( )
+        {
+        assert ( ! factored ) ;
+        const size_t  kv  =  kl + ku ;  //  superdiagonals of U
+        // Rows are equilibrated (each divided by its largest element) for rcond, and the
+        // 1-norm of the equilibrated matrix is taken now, before the band is overwritten.
+        rowScale.assign ( n, Real(0) ) ;
+        for ( size_t j = 0 ; j < n ; j ++ )
+          for ( size_t i = ( (j > ku) ? (j - ku) : 0 ) ; i <= std::min ( j + kl, n - 1 ) ; i ++ )
+            rowScale[i]  =  std::max ( rowScale[i], Real ( std::abs ( band ( kv + i - j, j ) ) ) ) ;
+        scaledNorm  =  Real(0) ;
+        for ( size_t j = 0 ; j < n ; j ++ )
+          {
+          Real  columnSum  =  Real(0) ;
+          for ( size_t i = ( (j > ku) ? (j - ku) : 0 ) ; i <= std::min ( j + kl, n - 1 ) ; i ++ )
+            if ( rowScale[i] > Real(0) )
+              columnSum  +=  std::abs ( band ( kv + i - j, j ) ) / rowScale[i] ;
+          scaledNorm  =  std::max ( scaledNorm, columnSum ) ;
+          } // end for j loop
+        size_t  lastColumn  =  0 ;      //  rightmost column reached by any interchanged row
+        for ( size_t j = 0 ; j < n ; j ++ )
+          {
+          size_t  below  =  std::min ( kl, n - 1 - j ) ;
+          size_t  p      =  0 ;
+          for ( size_t i = 1 ; i <= below ; i ++ )
+            if ( std::abs ( band ( kv + i, j ) ) > std::abs ( band ( kv + p, j ) ) )
+              p  =  i ;
+          pivot[j]  =  j + p ;
+          if ( band ( kv + p, j ) == Scalar(0) )
+            return  false ;
+          lastColumn  =  std::max ( lastColumn, std::min ( j + ku + p, n - 1 ) ) ;
+          if ( p != 0 )
+            for ( size_t c = j ; c <= lastColumn ; c ++ )
+              std::swap ( band ( kv + p + j - c, c ), band ( kv + j - c, c ) ) ;
+          Scalar  diagonal  =  band ( kv, j ) ;
+          for ( size_t i = 1 ; i <= below ; i ++ )
+            band ( kv + i, j )  /=  diagonal ;
+          for ( size_t c = j + 1 ; c <= lastColumn ; c ++ )
+            {
+            Scalar  u  =  band ( kv + j - c, c ) ;
+            if ( u != Scalar(0) )
+              for ( size_t i = 1 ; i <= below ; i ++ )
+                band ( kv + i + j - c, c )  -=  band ( kv + i, j ) * u ;
+            } // end for c loop
+          } // end for j loop
+        factored  =  true ;
+        return  true ;
+        } // end factorize
+
+      /**
+        * @brief
+        * Estimate of the reciprocal condition number, in the 1-norm, of the matrix with its rows
+        * equilibrated; requires <b><em>factorize</em></b>
+        *
+        * As for Eigen::PartialPivLU::rcond, a value near machine epsilon or below marks a matrix
+        * singular to working precision.  Rows are equilibrated first, so that rows of very
+        * different scale (e.g. high derivatives at the boundaries) do not count as ill-conditioning.
+        * The norm of the inverse is found by Hager's method, as refined by Higham
+        * (LAPACK's <em>lacn2</em>), from a few solves with the factors and their transpose.
+        * @return  the estimate, between 0 and 1
+        */
+      Real  rcond ( ) const
+        {
+        assert ( factored ) ;
+        if ( n == 0 )
+          return  Real(1) ;
+        for ( size_t i = 0 ; i < n ; i ++ )
+          if ( ! ( rowScale[i] > Real(0) ) )
+            return  Real(0) ;
+        // ||C||_1 for C = (R A)^-1 = A^-1 R^-1, where R divides each row by its scale.
+        Vector  x  =  Vector::Constant ( n, Scalar ( Real(1) / n ) ) ;
+        Real    inverseNorm  =  Real(0) ;
+        size_t  previous  =  n ;
+        for ( int iteration = 0 ; iteration < 5 ; iteration ++ )
+          {
+          Vector  y  =  x ;
+          for ( size_t i = 0 ; i < n ; i ++ )
+            y(i)  *=  rowScale[i] ;
+          solveInPlace ( y ) ;
+          Real  estimate  =  y.cwiseAbs().sum() ;
+          if ( (iteration > 0) && (estimate <= inverseNorm) )
+            break ;
+          inverseNorm  =  estimate ;
+          // z = C^H sign(y):  C^H = R^-1 A^-H, and A^-H w is the conjugate of A^-T conj(w).
+          Vector  z ( n ) ;
+          for ( size_t i = 0 ; i < n ; i ++ )
+            z(i)  =  ( std::abs ( y(i) ) > Real(0) ) ? Scalar ( Eigen::numext::conj ( y(i) ) / std::abs ( y(i) ) ) : Scalar(1) ;
+          solveTransposeInPlace ( z ) ;
+          size_t  j  =  0 ;
+          for ( size_t i = 0 ; i < n ; i ++ )
+            {
+            z(i)  =  Eigen::numext::conj ( z(i) ) * rowScale[i] ;
+            if ( std::abs ( z(i) ) > std::abs ( z(j) ) )
+              j  =  i ;
+            } // end for i loop
+          if ( j == previous )
+            break ;
+          previous  =  j ;
+          x.setZero ( ) ;
+          x(j)  =  Scalar(1) ;
+          } // end for iteration loop
+        // A second estimate, from an alternating vector, guards against the rare misses above.
+        Vector  y ( n ) ;
+        for ( size_t i = 0 ; i < n ; i ++ )
+          y(i)  =  Scalar ( ( (i % 2) ? Real(-1) : Real(1) ) * ( Real(1) + Real(i) / std::max<size_t> ( n - 1, 1 ) )
+                            * rowScale[i] ) ;
+        solveInPlace ( y ) ;
+        inverseNorm  =  std::max ( inverseNorm, Real(2) * y.cwiseAbs().sum() / ( Real(3) * n ) ) ;
+        if ( ! ( inverseNorm < std::numeric_limits<Real>::infinity() ) || (scaledNorm == Real(0)) )
+          return  Real(0) ;
+        return  std::min ( Real(1), Real(1) / ( scaledNorm * inverseNorm ) ) ;
+        } // end rcond
+
+      /**
+        * @brief
+        * Overwrite each column of <em>b</em> with the solution of&nbsp;
+        * <em>A</em>&nbsp;<em>x</em> = <em>b</em>; requires <b><em>factorize</em></b>
+        */
+      void  solveInPlace ( Eigen::Ref<Matrix> b ) const
+        {
+        assert ( factored && (static_cast<size_t>(b.rows()) == n) ) ;
+        const size_t  kv  =  kl + ku ;
+        // L:  the interchanges and unit lower-triangular eliminations, in order.
+        for ( size_t j = 0 ; j + 1 < n ; j ++ )
+          {
+          if ( pivot[j] != j )
+            b.row(j).swap ( b.row(pivot[j]) ) ;
+          size_t  below  =  std::min ( kl, n - 1 - j ) ;
+          for ( size_t i = 1 ; i <= below ; i ++ )
+            b.row(j + i)  -=  band ( kv + i, j ) * b.row(j) ;
+          } // end for j loop
+        // U:  back substitution, column by column.
+        for ( size_t j = n ; j -- > 0 ; )
+          {
+          b.row(j)  /=  band ( kv, j ) ;
+          size_t  first  =  ( j > kv ) ? ( j - kv ) : 0 ;
+          for ( size_t i = first ; i < j ; i ++ )
+            b.row(i)  -=  band ( kv + i - j, j ) * b.row(j) ;
+          } // end for j loop
+        } // end solveInPlace
+
+      /**
+        * @brief
+        * Overwrite each column of <em>b</em> with the solution of&nbsp;
+        * <em>A</em><sup>T</sup>&nbsp;<em>x</em> = <em>b</em> (the transpose, not the adjoint);
+        * requires <b><em>factorize</em></b>
+        */
+      void  solveTransposeInPlace ( Eigen::Ref<Matrix> b ) const
+        {
+        assert ( factored && (static_cast<size_t>(b.rows()) == n) ) ;
+        const size_t  kv  =  kl + ku ;
+        // U transposed:  forward substitution.
+        for ( size_t j = 0 ; j < n ; j ++ )
+          {
+          size_t  first  =  ( j > kv ) ? ( j - kv ) : 0 ;
+          for ( size_t i = first ; i < j ; i ++ )
+            b.row(j)  -=  band ( kv + i - j, j ) * b.row(i) ;
+          b.row(j)  /=  band ( kv, j ) ;
+          } // end for j loop
+        // L transposed:  the eliminations and interchanges undone in reverse order.
+        for ( size_t j = ( n > 0 ) ? ( n - 1 ) : 0 ; j -- > 0 ; )
+          {
+          size_t  below  =  std::min ( kl, n - 1 - j ) ;
+          for ( size_t i = 1 ; i <= below ; i ++ )
+            b.row(j)  -=  band ( kv + i, j ) * b.row(j + i) ;
+          if ( pivot[j] != j )
+            b.row(j).swap ( b.row(pivot[j]) ) ;
+          } // end for j loop
+        } // end solveTransposeInPlace
+
+      /**
+        * @brief
+        * Solution of&nbsp; <em>A</em>&nbsp;<em>x</em> = <em>b</em>; requires <b><em>factorize</em></b>
+        */
+      Vector  solve ( const Vector & b ) const
+        {
+        Vector  x  =  b ;
+        solveInPlace ( x ) ;
+        return  x ;
+        } // end solve
+
+      /**
+        * @brief
+        * Solution of&nbsp; <em>A</em>&nbsp;<em>X</em> = <em>B</em> &nbsp;for a block of right-hand sides
+        */
+      Matrix  solve ( const Matrix & b ) const
+        {
+        Matrix  x  =  b ;
+        solveInPlace ( x ) ;
+        return  x ;
+        } // end solve
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      size_t               n ;
+      size_t               kl ;
+      size_t               ku ;
+      Matrix               band ;      //  element (i,j) at band ( kl + ku + i - j, j )
+      std::vector<size_t>  pivot ;     //  row interchanged with row j at step j
+      std::vector<Real>    rowScale ;  //  largest element of each row, before factoring
+      Real                 scaledNorm ; // 1-norm of the matrix with each row divided by its scale
+      bool                 factored ;
+
+    } ; // end BandedLU class template
+
+  } // end namespace BSCM
+
+#endif  //  BANDEDLU_H
@@ -0,0 +1,174 @@
+/**
+ * @file    BoundaryValueSolver.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File BoundaryValueSolver.cpp contains the definition of the BoundaryValueSolver class,
+ * which factors a collocation operator once and solves with it repeatedly.
+ */
+
+#include <cassert>
+#include <limits>
+#include <vector>
+#include "BoundaryValueSolver.h"
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor with a constant shift
+BoundaryValueSolver::BoundaryValueSolver ( SplinePtr spline, size_t derivativeOrder, double scale, double shift )
+  : spline ( spline ), derivativeOrder ( derivativeOrder ), scale ( scale ),
+    shift ( Eigen::VectorXd::Constant ( spline->getN(), shift ) ), invertible ( false )
+  {
+  method  =  spline->isPeriodic() ? PERIODIC : BANDED ;
+  factor ( ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// constructor with a diagonal shift
+BoundaryValueSolver::BoundaryValueSolver ( SplinePtr spline, size_t derivativeOrder, double scale,
+                                           const Eigen::VectorXd & shift )
+  : spline ( spline ), derivativeOrder ( derivativeOrder ), scale ( scale ), shift ( shift ),
+    invertible ( false )
+  {
+  assert ( static_cast<size_t>(shift.size()) == spline->getN() ) ;
+  // The FFT diagonalizes a periodic operator only when the shift is constant.
+  bool  constant  =  ( shift.array() == shift(0) ).all() ;
+  method  =  ( ! spline->isPeriodic() ) ? BANDED : ( constant ? PERIODIC : DENSE ) ;
+  factor ( ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// constructor for an operator given as a matrix
+BoundaryValueSolver::BoundaryValueSolver ( const Eigen::MatrixXd & A, double shift )
+  : method ( DENSE ), derivativeOrder ( 0 ), scale ( 1.0 ),
+    shift ( Eigen::VectorXd::Constant ( A.rows(), shift ) ), invertible ( false ), denseOperator ( A )
+  {
+  assert ( A.rows() == A.cols() ) ;
+  factor ( ) ;
+  } // end constructor
+
+// ================================================================================================
+
+void  BoundaryValueSolver::factor ( )
+  {
+  if ( method == PERIODIC )
+    {
+    assert ( derivativeOrder < spline->getOrder() ) ;
+    assert ( scale != 0.0 ) ;
+    invertible  =  true ;  //  solvePeriodic discards any vanishing modes
+    return ;
+    } // end if
+
+  if ( method == DENSE )
+    {
+    if ( spline )
+      denseOperator  =  scale * spline->cachedOperatorMatrix ( derivativeOrder ) ;
+    denseOperator.diagonal()  +=  shift ;
+    denseFactors.compute ( denseOperator ) ;
+    invertible  =  ( denseFactors.rcond() > std::numeric_limits<double>::epsilon() ) ;
+    return ;
+    } // end if
+
+  // BANDED:  rows [ left rows of beta ; a D_p + sigma B ; right rows of beta ], as for B tilde.
+  const size_t  N      =  spline->getN() ;
+  const size_t  order  =  spline->getOrder() ;
+  const size_t  q      =  ( order - 1 ) / 2 ;
+  const Eigen::MatrixXd &  beta  =  spline->getBeta_matrix() ;
+  assert ( derivativeOrder < order ) ;
+
+  factors    =  BandedLU<double> ( N + order - 1, order - 1, order - 1 ) ;
+  basisBand.resize ( N, order ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      factors.coeffRef ( r, l )  =  beta ( r, l ) ;
+      if ( l + 1 < order )
+        factors.coeffRef ( q + N + r, N + l )  =  beta ( q + r, N + l ) ;
+      } // end for l loop
+  std::vector<double>  B ( order ), D ( order ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    double  x  =  spline->getCollocationX()[alpha] ;
+    size_t  first  =  spline->nonzeroBasis ( 0, x, &B[0] ) ;
+    spline->nonzeroBasis ( derivativeOrder, x, &D[0] ) ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      basisBand ( alpha, l )  =  B[l] ;
+      factors.coeffRef ( q + alpha, first + l )  =  scale * D[l] + shift(alpha) * B[l] ;
+      } // end for l loop
+    } // end for alpha loop
+  // As for the dense factors, singular to working precision counts as singular; rounding in the
+  // banded factors grows with the width of the band, and the estimate may be off by a few times.
+  const double  tolerance  =  10.0 * ( 2 * order - 1 ) * std::numeric_limits<double>::epsilon() ;
+  invertible  =  factors.factorize ( ) && ( factors.rcond() > tolerance ) ;
+  } // end factor
+
+// ================================================================================================
+
+Eigen::MatrixXd  BoundaryValueSolver::solveFactored ( const Eigen::MatrixXd & rho ) const
+  {
+  assert ( invertible ) ;
+  if ( method == DENSE )
+    return  denseFactors.solve ( rho ) ;
+
+  const size_t  N  =  spline->getN() ;
+  Eigen::MatrixXd  u ( N, rho.cols() ) ;
+  if ( method == PERIODIC )
+    {
+    // ( a O + sigma ) u = rho  is  ( O + sigma/a ) u = rho/a.
+    for ( long k = 0 ; k < rho.cols() ; k ++ )
+      u.col ( k )  =  spline->solvePeriodic ( derivativeOrder, rho.col(k) / scale, shift(0) / scale ) ;
+    return  u ;
+    } // end if
+
+  // BANDED:  the coefficients, with the boundary rows of beta set to zero, then u = B c.
+  const size_t  order  =  spline->getOrder() ;
+  const size_t  q      =  ( order - 1 ) / 2 ;
+  Eigen::MatrixXd  c  =  Eigen::MatrixXd::Zero ( N + order - 1, rho.cols() ) ;
+  c.middleRows ( q, N )  =  rho ;
+  factors.solveInPlace ( c ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  first  =  spline->firstBasis ( alpha ) ;
+    u.row ( alpha )  =  basisBand ( alpha, 0 ) * c.row ( first ) ;
+    for ( size_t l = 1 ; l < order ; l ++ )
+      u.row ( alpha )  +=  basisBand ( alpha, l ) * c.row ( first + l ) ;
+    } // end for alpha loop
+  return  u ;
+  } // end solveFactored
+
+// ================================================================================================
+
+Eigen::MatrixXd  BoundaryValueSolver::solve ( const Eigen::MatrixXd & rho, size_t refinementSteps ) const
+  {
+  assert ( rho.rows() == shift.size() ) ;
+  Eigen::MatrixXd  u  =  solveFactored ( rho ) ;
+  for ( size_t s = 0 ; s < refinementSteps ; s ++ )
+    u  +=  solveFactored ( rho - apply ( u ) ) ;
+  return  u ;
+  } // end solve
+
+// ================================================================================================
+
+Eigen::MatrixXd  BoundaryValueSolver::apply ( const Eigen::MatrixXd & u ) const
+  {
+  assert ( u.rows() == shift.size() ) ;
+  if ( method == DENSE )
+    return  denseOperator * u ;
+  Eigen::MatrixXd  result ( u.rows(), u.cols() ) ;
+  for ( long k = 0 ; k < u.cols() ; k ++ )
+    result.col ( k )  =  scale * spline->applyOperator ( derivativeOrder, u.col(k) )
+                       + shift.cwiseProduct ( u.col(k) ) ;
+  return  result ;
+  } // end apply
+
+// ================================================================================================
@@ -0,0 +1,161 @@
+/**
+ * @file    BoundaryValueSolver.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File BoundaryValueSolver.h contains the declaration of the BoundaryValueSolver class,
+ * which factors a collocation operator once and solves with it repeatedly.
+ */
+
+#ifndef  BOUNDARYVALUESOLVER_H
+#define  BOUNDARYVALUESOLVER_H
+
+#include <Eigen/Dense>
+#include <Eigen/LU>
+#include "Spline.h"
+#include "BandedLU.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %BoundaryValueSolver solves&nbsp;
+   * (&nbsp;<em>a</em>&nbsp;<em>O</em><sup>&nbsp;(p)</sup> + &sigma;&nbsp;)&nbsp;<em>u</em> = &rho;
+   * &nbsp;for any number of right-hand sides &rho;, factoring the operator only once.
+   *
+   * <em>O</em><sup>&nbsp;(p)</sup> = operatorMatrix(<em>p</em>), and the shift &sigma; is either a
+   * constant or a diagonal given at the collocation points; e.g. <em>p</em> = 2, <em>a</em> = 1,
+   * &sigma; = 0 is the Poisson equation of Umar's Coulomb problem, and
+   * <em>a</em> = &minus;&kappa;, &sigma; = 1/<em>dt</em> an implicit heat step.\n\n
+   * For a non-periodic %Spline, <em>u</em> = <em>B</em>&nbsp;<em>c</em> and
+   * <em>O</em><sup>&nbsp;(p)</sup>&nbsp;<em>u</em> = <em>D<sub>p</sub></em>&nbsp;<em>c</em>, where
+   * <em>D<sub>p</sub></em> holds the <em>p<sup>&nbsp;th</sup></em> derivatives of the basis at the
+   * collocation points, so the equations become&nbsp;
+   * (&nbsp;<em>a</em>&nbsp;<em>D<sub>p</sub></em> + &sigma;&nbsp;<em>B</em>&nbsp;)&nbsp;<em>c</em> = &rho;,
+   * &nbsp;&beta;&nbsp;<em>c</em> = 0:&nbsp; a bordered system with the band of Umar's "B tilde".
+   * It is factored in O(<b><em>N</em></b>&nbsp;<b><em>M</em></b><sup>&nbsp;2</sup>) operations, and
+   * each right-hand side is then solved in O(<b><em>N</em></b>&nbsp;<b><em>M</em></b>).\n
+   * For a periodic %Spline with a constant shift, each solve is made by FFT
+   * (see Spline::solvePeriodic).  Otherwise (a periodic %Spline with a varying shift,
+   * or an operator given as a matrix) the dense matrix is LU-factored once.\n\n
+   * Each solve may be followed by steps of iterative refinement, which recompute the residual
+   * with the operator itself (not its factors) and correct <em>u</em> by solving for it.
+   */
+
+  class  BoundaryValueSolver
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Factor&nbsp; <em>a</em>&nbsp;<em>O</em><sup>&nbsp;(p)</sup> + &sigma;
+        * &nbsp;for a constant shift
+        *
+        * @param spline           %Spline supplying <em>O</em><sup>&nbsp;(p)</sup>
+        * @param derivativeOrder  <em>p</em>
+        * @param scale            <em>a</em>
+        * @param shift            &sigma;
+        */
+      BoundaryValueSolver ( SplinePtr spline, size_t derivativeOrder, double scale = 1.0, double shift = 0.0 ) ;
+
+      /**
+        * @brief
+        * Factor&nbsp; <em>a</em>&nbsp;<em>O</em><sup>&nbsp;(p)</sup> + diag(&sigma;)
+        *
+        * @param spline           %Spline supplying <em>O</em><sup>&nbsp;(p)</sup>
+        * @param derivativeOrder  <em>p</em>
+        * @param scale            <em>a</em>
+        * @param shift            &sigma; at the <b><em>N</em></b> collocation points
+        */
+      BoundaryValueSolver ( SplinePtr spline, size_t derivativeOrder, double scale,
+                            const Eigen::VectorXd & shift ) ;
+
+      /**
+        * @brief
+        * Factor&nbsp; <em>A</em> + &sigma; &nbsp;for an operator given as a matrix
+        *
+        * @param A      Square operator matrix
+        * @param shift  &sigma;
+        */
+      explicit BoundaryValueSolver ( const Eigen::MatrixXd & A, double shift = 0.0 ) ;
+
+      /**
+        * @brief
+        * false if the operator was found to be singular
+        *
+        * Singular means singular to working precision, judged by an estimate of the reciprocal
+        * condition number (BandedLU::rcond, or Eigen::PartialPivLU::rcond for the dense factors);
+        * e.g. the Poisson operator with Neumann conditions at both boundaries.
+        */
+      bool  good ( ) const  { return  invertible ; }
+
+      /**
+        * @brief
+        * Solutions for a block of right-hand sides, one per column
+        *
+        * A single right-hand side is a block of one column; as for <b><em>apply</em></b>, there is
+        * no separate vector overload, so that any Eigen expression may be passed.
+        * @param rho              &rho;, <b><em>N</em></b> by <em>K</em>
+        * @param refinementSteps  Number of steps of iterative refinement
+        * @return  Eigen::MatrixXd
+        */
+      Eigen::MatrixXd  solve ( const Eigen::MatrixXd & rho, size_t refinementSteps = 0 ) const ;
+
+      /**
+        * @brief
+        * (&nbsp;<em>a</em>&nbsp;<em>O</em><sup>&nbsp;(p)</sup> + &sigma;&nbsp;)&nbsp;<em>u</em>
+        * &nbsp;for each column of <em>u</em>, without the factors
+        *
+        * @return  Eigen::MatrixXd
+        */
+      Eigen::MatrixXd  apply ( const Eigen::MatrixXd & u ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      /**
+        * How the operator was factored.
+        */
+      enum  Method  { BANDED, PERIODIC, DENSE } ;
+
+      Method           method ;
+      SplinePtr        spline ;           //  empty for an operator given as a matrix
+      size_t           derivativeOrder ;
+      double           scale ;
+      Eigen::VectorXd  shift ;            //  one entry per collocation point
+      bool             invertible ;
+
+      /**
+        * BANDED:  row &alpha; of basisBand holds <em>B</em> in columns firstBasis(&alpha;) onward, and
+        * factors holds the bordered system, with rows ordered as in %Spline.
+        */
+      Eigen::MatrixXd   basisBand ;
+      BandedLU<double>  factors ;
+
+      /**
+        * DENSE:  the operator (shift included) and its LU factors.
+        */
+      Eigen::MatrixXd                       denseOperator ;
+      Eigen::PartialPivLU<Eigen::MatrixXd>  denseFactors ;
+
+      /**
+        * Set the factors up for the chosen method.
+        */
+      void  factor ( ) ;
+
+      /**
+        * Solve once, without refinement.
+        */
+      Eigen::MatrixXd  solveFactored ( const Eigen::MatrixXd & rho ) const ;
+
+    } ; // end BoundaryValueSolver class
+
+  } // end namespace BSCM
+
+#endif  //  BOUNDARYVALUESOLVER_H
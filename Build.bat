@@ -1,14 +1,115 @@
 del *.o
 del *.exe
 cls
+H:\JASolheim\MinGW\bin\g++.exe CollocationStrategy.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o CollocationStrategy.o
+
 H:\JASolheim\MinGW\bin\g++.exe Spline.cpp ^
--Wall -c -O2 ^
+-Wall -c -O2 -std=c++11 -pthread ^
 -o Spline.o ^
 -I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
 
+H:\JASolheim\MinGW\bin\g++.exe TimeSeries.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o TimeSeries.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe Checkpoint.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o Checkpoint.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe SplineFitter.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o SplineFitter.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe BoundaryValueSolver.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o BoundaryValueSolver.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe Stepper.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o Stepper.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe SpectralPropagator.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o SpectralPropagator.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe FastDiagonalization.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o FastDiagonalization.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe KrylovPropagator.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o KrylovPropagator.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe CayleyPropagator.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o CayleyPropagator.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe DomainDecomposition.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o DomainDecomposition.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
 H:\JASolheim\MinGW\bin\g++.exe main.cpp ^
--Wall -c -O2 ^
+-Wall -c -O2 -std=c++11 ^
 -o main.o ^
 -I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
 
-H:\JASolheim\MinGW\bin\g++.exe -o main.exe Spline.o main.o
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o main.exe CollocationStrategy.o Spline.o TimeSeries.o KrylovPropagator.o main.o
+
+H:\JASolheim\MinGW\bin\g++.exe ThreadPool.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o ThreadPool.o
+
+H:\JASolheim\MinGW\bin\g++.exe sweep.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o sweep.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o sweep.exe CollocationStrategy.o Spline.o ThreadPool.o sweep.o
+
+rem  stepperTest is compiled in one command so that every file sees EIGEN_RUNTIME_NO_MALLOC.
+H:\JASolheim\MinGW\bin\g++.exe stepperTest.cpp Stepper.cpp Spline.cpp CollocationStrategy.cpp ^
+-Wall -O2 -std=c++11 -pthread -DEIGEN_RUNTIME_NO_MALLOC ^
+-o stepperTest.exe ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+rem  splineThreadTest is meant for ThreadSanitizer, which MinGW lacks; elsewhere build it with
+rem  g++ -std=c++11 -O1 -g -fsanitize=thread -pthread splineThreadTest.cpp Spline.cpp CollocationStrategy.cpp
+H:\JASolheim\MinGW\bin\g++.exe splineThreadTest.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o splineThreadTest.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o splineThreadTest.exe CollocationStrategy.o Spline.o splineThreadTest.o
+
+H:\JASolheim\MinGW\bin\g++.exe boundaryValueSolverTest.cpp ^
+-Wall -c -O2 -std=c++11 ^
+-o boundaryValueSolverTest.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o boundaryValueSolverTest.exe CollocationStrategy.o Spline.o BoundaryValueSolver.o boundaryValueSolverTest.o
+
+H:\JASolheim\MinGW\bin\g++.exe domainDecompositionTest.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o domainDecompositionTest.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o domainDecompositionTest.exe CollocationStrategy.o Spline.o DomainDecomposition.o domainDecompositionTest.o
+
+H:\JASolheim\MinGW\bin\g++.exe fastDiagonalizationTest.cpp ^
+-Wall -c -O2 -std=c++11 -pthread ^
+-o fastDiagonalizationTest.o ^
+-I"H:\JASolheim\EIGEN-~1\EIGEN-~1"
+
+H:\JASolheim\MinGW\bin\g++.exe -pthread -o fastDiagonalizationTest.exe CollocationStrategy.o Spline.o ThreadPool.o FastDiagonalization.o fastDiagonalizationTest.o
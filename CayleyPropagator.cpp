@@ -0,0 +1,133 @@
+/**
+ * @file    CayleyPropagator.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File CayleyPropagator.cpp contains the definition of the CayleyPropagator class,
+ * which advances complex wavefunctions under the time-dependent Schr&ouml;dinger equation.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "CayleyPropagator.h"
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor
+CayleyPropagator::CayleyPropagator ( SplinePtr spline, const Eigen::VectorXd & potential, double dt,
+                                     double kineticFactor )
+  : spline ( spline ), N ( spline->getN() ), order ( spline->getOrder() ), dt ( dt ),
+    kineticFactor ( kineticFactor ), potential ( potential ),
+    basisBand ( spline->getN(), spline->getOrder() ), explicitBand ( spline->getN(), spline->getOrder() ),
+    lastNormDrift ( 0.0 ), lastStepsPerSecond ( 0.0 )
+  {
+  assert ( ! spline->isPeriodic() ) ;
+  assert ( static_cast<size_t>(potential.size()) == N ) ;
+
+  const size_t     q     =  ( order - 1 ) / 2 ;
+  const size_t     n     =  N + order - 1 ;
+  const Complex    half  =  Complex ( 0.0, 0.5 * dt ) ;  //  i dt / 2
+  const Eigen::MatrixXd &  beta  =  spline->getBeta_matrix() ;
+
+  coefficientFactors  =  BandedLU<Complex> ( n, order - 1, order - 1 ) ;
+  implicitFactors     =  BandedLU<Complex> ( n, order - 1, order - 1 ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      coefficientFactors.coeffRef ( r, l )  =  implicitFactors.coeffRef ( r, l )  =  beta ( r, l ) ;
+      if ( l + 1 < order )
+        coefficientFactors.coeffRef ( q + N + r, N + l )  =  implicitFactors.coeffRef ( q + N + r, N + l )
+                                                          =  beta ( q + r, N + l ) ;
+      } // end for l loop
+
+  // At collocation point alpha only B(M,first+l), l = 0 .. M-1, are nonzero.
+  std::vector<double>  B ( order ), D2 ( order ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    double  x      =  spline->getCollocationX()[alpha] ;
+    size_t  first  =  spline->nonzeroBasis ( 0, x, &B[0] ) ;
+    spline->nonzeroBasis ( 2, x, &D2[0] ) ;
+    assert ( first == spline->firstBasis ( alpha ) ) ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      Complex  Hc  =  potential(alpha) * B[l] - kineticFactor * D2[l] ;  //  H acting on coefficient first+l
+      basisBand    ( alpha, l )  =  B[l] ;
+      explicitBand ( alpha, l )  =  B[l] - half * Hc ;
+      coefficientFactors.coeffRef ( q + alpha, first + l )  =  B[l] ;
+      implicitFactors.coeffRef    ( q + alpha, first + l )  =  B[l] + half * Hc ;
+      } // end for l loop
+    } // end for alpha loop
+
+  bool  invertible  =  coefficientFactors.factorize ( ) && implicitFactors.factorize ( ) ;
+  assert ( invertible ) ;
+  (void) invertible ;
+  } // end constructor
+
+// ================================================================================================
+
+void  CayleyPropagator::propagate ( Eigen::Ref<Eigen::MatrixXcd> psi, size_t steps )
+  {
+  assert ( static_cast<size_t>(psi.rows()) == N ) ;
+  std::chrono::steady_clock::time_point  start  =  std::chrono::steady_clock::now() ;
+
+  const size_t     q  =  ( order - 1 ) / 2 ;
+  const size_t     n  =  N + order - 1 ;
+  Eigen::VectorXd  initialNorms  =  psi.colwise().norm().transpose() ;
+
+  // Coefficients of the wavefunctions, with the boundary rows of beta set to zero.
+  Eigen::MatrixXcd  c  =  Eigen::MatrixXcd::Zero ( n, psi.cols() ) ;
+  c.middleRows ( q, N )  =  psi ;
+  coefficientFactors.solveInPlace ( c ) ;
+
+  Eigen::MatrixXcd  rhs  =  Eigen::MatrixXcd::Zero ( n, psi.cols() ) ;
+  for ( size_t s = 0 ; s < steps ; s ++ )
+    {
+    rhs.topRows    ( q ).setZero ( ) ;
+    rhs.bottomRows ( q ).setZero ( ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      {
+      size_t  first  =  spline->firstBasis ( alpha ) ;
+      rhs.row ( q + alpha )  =  explicitBand ( alpha, 0 ) * c.row ( first ) ;
+      for ( size_t l = 1 ; l < order ; l ++ )
+        rhs.row ( q + alpha )  +=  explicitBand ( alpha, l ) * c.row ( first + l ) ;
+      } // end for alpha loop
+    implicitFactors.solveInPlace ( rhs ) ;
+    c.swap ( rhs ) ;
+    } // end for s loop
+
+  // Back to collocation values:  psi = B c.
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  first  =  spline->firstBasis ( alpha ) ;
+    psi.row ( alpha )  =  basisBand ( alpha, 0 ) * c.row ( first ) ;
+    for ( size_t l = 1 ; l < order ; l ++ )
+      psi.row ( alpha )  +=  basisBand ( alpha, l ) * c.row ( first + l ) ;
+    } // end for alpha loop
+
+  double  seconds  =  std::chrono::duration<double> ( std::chrono::steady_clock::now() - start ).count() ;
+  lastStepsPerSecond  =  ( seconds > 0.0 ) ? ( steps * psi.cols() / seconds ) : 0.0 ;
+  lastNormDrift       =  0.0 ;
+  for ( long k = 0 ; k < psi.cols() ; k ++ )
+    if ( initialNorms(k) > 0.0 )
+      lastNormDrift  =  std::max ( lastNormDrift, std::abs ( psi.col(k).norm() / initialNorms(k) - 1.0 ) ) ;
+  } // end propagate
+
+// ================================================================================================
+
+Eigen::VectorXcd  CayleyPropagator::applyHamiltonian ( const Eigen::VectorXcd & psi ) const
+  {
+  assert ( static_cast<size_t>(psi.size()) == N ) ;
+  return  potential.cwiseProduct ( psi ) - kineticFactor * spline->applyComplexOperator ( 2, psi ) ;
+  } // end applyHamiltonian
+
+// ================================================================================================
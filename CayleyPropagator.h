@@ -0,0 +1,140 @@
+/**
+ * @file    CayleyPropagator.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File CayleyPropagator.h contains the declaration of the CayleyPropagator class,
+ * which advances complex wavefunctions under the time-dependent Schr&ouml;dinger equation.
+ */
+
+#ifndef  CAYLEYPROPAGATOR_H
+#define  CAYLEYPROPAGATOR_H
+
+#include <complex>
+#include <Eigen/Dense>
+#include "Spline.h"
+#include "BandedLU.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %CayleyPropagator advances wavefunctions &psi; under&nbsp;
+   * <em>i</em>&nbsp;&part;&psi;/&part;<em>t</em> = <em>H</em>&nbsp;&psi;, &nbsp;with&nbsp;
+   * <em>H</em> = &minus;<em>a</em>&nbsp;<em>O</em><sup>&nbsp;(2)</sup> + <em>V</em>,
+   * by the Cayley (Crank&ndash;Nicolson) form&nbsp;
+   * (&nbsp;1 + <em>i</em>&nbsp;<em>dt</em>&nbsp;<em>H</em>/2&nbsp;)&nbsp;&psi;<sub><em>n</em>+1</sub> =
+   * (&nbsp;1 &minus; <em>i</em>&nbsp;<em>dt</em>&nbsp;<em>H</em>/2&nbsp;)&nbsp;&psi;<sub><em>n</em></sub>.
+   *
+   * <em>O</em><sup>&nbsp;(2)</sup> = operatorMatrix(2), <em>V</em> is a potential given at the
+   * collocation points, and <em>a</em> is &hbar;<sup>2</sup>/(2&nbsp;<em>m</em>) (1/2 in atomic units).\n\n
+   * With &psi; = <em>B</em>&nbsp;<em>c</em> for spline coefficients <em>c</em> satisfying
+   * &beta;&nbsp;<em>c</em> = 0, <em>H</em>&nbsp;&psi; = &minus;<em>a</em>&nbsp;<em>D</em><sub>2</sub>&nbsp;<em>c</em>
+   * + <em>V</em>&nbsp;<em>B</em>&nbsp;<em>c</em>, where <em>D</em><sub>2</sub> holds the second
+   * derivatives of the basis at the collocation points.  Both sides of the step are therefore
+   * banded in <em>c</em>:  the left side, bordered by the rows of &beta;, has the band structure of
+   * Umar's "B tilde" and is factored (in complex arithmetic) once, by the constructor.  Each step
+   * of each wavefunction then costs O(<b><em>N</em></b>&nbsp;<b><em>M</em></b>), and no
+   * <b><em>N</em></b> by <b><em>N</em></b> matrix is formed.  The wavefunctions are held as
+   * coefficients between the steps of one <b><em>propagate</em></b>, and any number of them are
+   * advanced together, as the columns of a matrix.\n\n
+   * The Cayley form is exactly norm-preserving when <em>H</em> is Hermitian.  The collocation
+   * operator is not quite symmetric, so <b><em>propagate</em></b> reports the drift of the norm
+   * of the collocation values, together with its throughput.
+   * Not available for a periodic %Spline.
+   */
+
+  class  CayleyPropagator
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Factor the left side of the step for <em>spline</em>, <em>potential</em> &amp; <em>dt</em>
+        *
+        * @param spline         Non-periodic %Spline supplying <em>O</em><sup>&nbsp;(2)</sup>
+        * @param potential      <em>V</em> at the <b><em>N</em></b> collocation points
+        * @param dt             Time step
+        * @param kineticFactor  <em>a</em> = &hbar;<sup>2</sup>/(2&nbsp;<em>m</em>)
+        */
+      CayleyPropagator ( SplinePtr spline, const Eigen::VectorXd & potential, double dt,
+                         double kineticFactor = 0.5 ) ;
+
+      /**
+        * @brief
+        * Advance each column of <em>psi</em>, a wavefunction at the collocation points,
+        * by <em>steps</em> time steps
+        *
+        * @param psi    <b><em>N</em></b> by <em>K</em> matrix of wavefunctions, overwritten
+        * @param steps  Number of time steps
+        */
+      void  propagate ( Eigen::Ref<Eigen::MatrixXcd> psi, size_t steps = 1 ) ;
+
+      /**
+        * @brief
+        * <em>H</em>&nbsp;&psi;, &nbsp;for expectation values such as the energy
+        *
+        * @return  Eigen::VectorXcd
+        */
+      Eigen::VectorXcd  applyHamiltonian ( const Eigen::VectorXcd & psi ) const ;
+
+      /** @brief Time step */
+      double  getDt ( ) const  { return  dt ; }
+
+      /**
+        * @brief
+        * Largest relative change in the norm of any wavefunction during the last
+        * <b><em>propagate</em></b>
+        */
+      double  normDrift ( ) const  { return  lastNormDrift ; }
+
+      /**
+        * @brief
+        * Wavefunction steps (steps &times; wavefunctions) per second in the last
+        * <b><em>propagate</em></b>
+        */
+      double  stepsPerSecond ( ) const  { return  lastStepsPerSecond ; }
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      typedef  std::complex<double>  Complex ;
+
+      SplinePtr        spline ;
+      size_t           N ;
+      size_t           order ;
+      double           dt ;
+      double           kineticFactor ;
+      Eigen::VectorXd  potential ;
+
+      /**
+        * Row &alpha; of each holds the entries of its matrix in columns firstBasis(&alpha;) onward:
+        * basisBand for <em>B</em>, and explicitBand for
+        * <em>B</em> &minus; <em>i</em>&nbsp;<em>dt</em>&nbsp;(&nbsp;<em>V</em>&nbsp;<em>B</em> &minus; <em>a</em>&nbsp;<em>D</em><sub>2</sub>&nbsp;)/2.
+        */
+      Eigen::MatrixXd   basisBand ;
+      Eigen::MatrixXcd  explicitBand ;
+
+      /**
+        * Factors of "B tilde", for the coefficients of the initial wavefunctions, and of
+        * "B tilde" with <em>B</em> replaced by
+        * <em>B</em> + <em>i</em>&nbsp;<em>dt</em>&nbsp;(&nbsp;<em>V</em>&nbsp;<em>B</em> &minus; <em>a</em>&nbsp;<em>D</em><sub>2</sub>&nbsp;)/2,
+        * for each step; rows are ordered as in %Spline.
+        */
+      BandedLU<Complex>  coefficientFactors ;
+      BandedLU<Complex>  implicitFactors ;
+
+      double  lastNormDrift ;
+      double  lastStepsPerSecond ;
+
+    } ; // end CayleyPropagator class
+
+  } // end namespace BSCM
+
+#endif  //  CAYLEYPROPAGATOR_H
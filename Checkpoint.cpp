@@ -0,0 +1,424 @@
+/**
+ * @file    Checkpoint.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File Checkpoint.cpp contains the definitions of the CheckpointWriter and
+ * CheckpointReader classes, which save &amp; restore the state of a BSCM time loop.
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include "Checkpoint.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <io.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+using namespace BSCM ;
+
+namespace
+  {
+  const char      MAGIC [ 8 ]  =  { 'B', 'S', 'C', 'M', 'C', 'P', '0', '1' } ;
+  const uint32_t  VERSION      =  2 ;
+
+  const uint64_t  FNV_OFFSET  =  14695981039346656037ULL ;
+  const uint64_t  FNV_PRIME   =  1099511628211ULL ;
+
+  // Fold the bytes [ data, data + size ) into the FNV-1a hash h.
+  uint64_t  hashBytes ( uint64_t h, const void * data, size_t size )
+    {
+    const unsigned char *  bytes  =  static_cast<const unsigned char *> ( data ) ;
+    for ( size_t b = 0 ; b < size ; b ++ )
+      h  =  ( h ^ bytes[b] ) * FNV_PRIME ;
+    return  h ;
+    } // end hashBytes
+
+  // Append the bytes of value to buffer.
+  template < typename T >
+  void  append ( std::vector<char> & buffer, const T & value )
+    {
+    const char *  bytes  =  reinterpret_cast<const char *> ( &value ) ;
+    buffer.insert ( buffer.end(), bytes, bytes + sizeof(T) ) ;
+    } // end append
+
+  // Copy the next value out of the buffer, advancing offset.
+  template < typename T >
+  bool  extract ( const std::vector<char> & buffer, size_t size, size_t & offset, T & value )
+    {
+    if ( offset + sizeof(T) > size )
+      return  false ;
+    std::memcpy ( &value, &buffer[offset], sizeof(T) ) ;
+    offset  +=  sizeof(T) ;
+    return  true ;
+    } // end extract
+
+  // Copy count doubles out of the buffer, advancing offset.
+  bool  extractArray ( const std::vector<char> & buffer, size_t size, size_t & offset,
+                       double * values, size_t count )
+    {
+    if ( offset + count * sizeof(double) > size )
+      return  false ;
+    if ( count > 0 )
+      std::memcpy ( values, &buffer[offset], count * sizeof(double) ) ;
+    offset  +=  count * sizeof(double) ;
+    return  true ;
+    } // end extractArray
+
+  size_t  roundUpTo8 ( size_t bytes )
+    {
+    return  ( bytes + 7 ) & ~ static_cast<size_t>(7) ;
+    } // end roundUpTo8
+
+  // Write size bytes to file, folding them into checksum.
+  bool  writeHashed ( std::FILE * file, uint64_t & checksum, const void * data, size_t size )
+    {
+    checksum  =  hashBytes ( checksum, data, size ) ;
+    return  ( size == 0 ) || ( std::fwrite ( data, 1, size, file ) == size ) ;
+    } // end writeHashed
+
+  // Push the file's buffered data through to the disk.
+  bool  syncToDisk ( std::FILE * file )
+    {
+    if ( std::fflush ( file ) != 0 )
+      return  false ;
+#ifdef _WIN32
+    return  _commit ( _fileno ( file ) ) == 0 ;
+#else
+    return  fsync ( fileno ( file ) ) == 0 ;
+#endif
+    } // end syncToDisk
+
+  // Rename source over target in one step, so target is never incomplete.
+  bool  replaceFile ( const std::string & source, const std::string & target )
+    {
+#ifdef _WIN32
+    return  MoveFileExA ( source.c_str(), target.c_str(),
+                          MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0 ;
+#else
+    if ( std::rename ( source.c_str(), target.c_str() ) != 0 )
+      return  false ;
+    // Make the rename itself durable by syncing the directory holding target.
+    size_t       slash      =  target.find_last_of ( '/' ) ;
+    std::string  directory  =  ( slash == std::string::npos ) ? std::string ( "." )
+                                                              : target.substr ( 0, slash + 1 ) ;
+    int  fd  =  open ( directory.c_str(), O_RDONLY ) ;
+    if ( fd >= 0 )
+      {
+      fsync ( fd ) ;
+      ::close ( fd ) ;
+      } // end if
+    return  true ;
+#endif
+    } // end replaceFile
+  } // end anonymous namespace
+
+// ================================================================================================
+
+// constructor
+CheckpointWriter::CheckpointWriter ( const std::string & fileName, const Spline & spline, double dt,
+                                     std::shared_ptr<const Eigen::MatrixXd> propagator,
+                                     std::shared_ptr<const Eigen::MatrixXd> forcing,
+                                     bool embedOperators )
+  : fileName ( fileName ), N ( spline.getN() ), embedOperators ( embedOperators ),
+    propagator ( propagator ), forcing ( forcing ),
+    fillState ( spline.getN() ), flushState ( spline.getN() ), fillStep ( 0 ), flushStep ( 0 ),
+    snapshotPending ( false ), closing ( false ), failed ( false ), writtenStep ( 0 )
+  {
+  assert ( propagator && (static_cast<size_t>(propagator->rows()) == N)
+                      && (static_cast<size_t>(propagator->cols()) == N) ) ;
+  assert ( ! forcing || (static_cast<size_t>(forcing->rows()) == N) ) ;
+
+  // Assemble the header, which is the same for every checkpoint of the run.
+  const Eigen::MatrixXi &  K  =  spline.getK_matrix() ;
+  header.assign ( MAGIC, MAGIC + sizeof(MAGIC) ) ;
+  append ( header, VERSION ) ;
+  append ( header, static_cast<uint32_t> ( spline.getOrder() ) ) ;
+  append ( header, static_cast<uint64_t> ( N ) ) ;
+  append ( header, static_cast<uint64_t> ( spline.getNumKnots() ) ) ;
+  append ( header, static_cast<uint64_t> ( K.rows() ) ) ;
+  append ( header, static_cast<uint64_t> ( K.cols() ) ) ;
+  append ( header, static_cast<uint64_t> ( spline.isPeriodic() ? 1 : 0 ) ) ;
+  append ( header, spline.getXMin() ) ;
+  append ( header, spline.getXMax() ) ;
+  append ( header, dt ) ;
+  append ( header, static_cast<uint64_t> ( forcing ? forcing->cols() : 0 ) ) ;
+  append ( header, static_cast<uint64_t> ( embedOperators ? 1 : 0 ) ) ;
+  append ( header, operatorHash ( *propagator ) ) ;
+  append ( header, forcing ? operatorHash ( *forcing ) : static_cast<uint64_t>(0) ) ;
+  for ( size_t j = 0 ; j < spline.getNumKnots() ; j ++ )
+    append ( header, spline.getKnotX()[j] ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    append ( header, spline.getCollocationX()[alpha] ) ;
+  for ( int r = 0 ; r < K.rows() ; r ++ )
+    for ( int p = 0 ; p < K.cols() ; p ++ )
+      append ( header, static_cast<int32_t> ( K(r,p) ) ) ;
+  header.resize ( roundUpTo8 ( header.size() ), 0 ) ;
+
+  flusher  =  std::thread ( &CheckpointWriter::flushLoop, this ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// destructor
+CheckpointWriter::~CheckpointWriter ( )
+  {
+  close ( ) ;
+  } // end destructor
+
+// ================================================================================================
+
+uint64_t  CheckpointWriter::operatorHash ( const Eigen::MatrixXd & A )
+  {
+  uint64_t  rows  =  A.rows() ;
+  uint64_t  cols  =  A.cols() ;
+  uint64_t  h     =  hashBytes ( FNV_OFFSET, &rows, sizeof(rows) ) ;
+  h  =  hashBytes ( h, &cols, sizeof(cols) ) ;
+  return  hashBytes ( h, A.data(), A.size() * sizeof(double) ) ;
+  } // end operatorHash
+
+// ================================================================================================
+
+void  CheckpointWriter::save ( uint64_t step, const Eigen::VectorXd & u )
+  {
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  // The lock is only ever held for a copy or a swap, never during file I/O.
+  std::lock_guard<std::mutex>  lock ( snapshotMutex ) ;
+  fillState        =  u ;   //  same size, so no allocation
+  fillStep         =  step ;
+  snapshotPending  =  true ;
+  snapshotChanged.notify_all ( ) ;
+  } // end save
+
+// ================================================================================================
+
+void  CheckpointWriter::flushLoop ( )
+  {
+  std::unique_lock<std::mutex>  lock ( snapshotMutex ) ;
+  for ( ; ; )
+    {
+    while ( ! snapshotPending && ! closing )
+      snapshotChanged.wait ( lock ) ;
+    if ( ! snapshotPending )
+      return ;  //  closing, and nothing left to write
+
+    // flushState belongs to this thread; save may refill fillState meanwhile.
+    fillState.swap ( flushState ) ;
+    flushStep        =  fillStep ;
+    snapshotPending  =  false ;
+    lock.unlock ( ) ;
+    bool  ok  =  writeSnapshot ( ) ;
+    lock.lock ( ) ;
+    if ( ok )
+      writtenStep  =  flushStep ;
+    else
+      failed  =  true ;
+    } // end for loop
+  } // end flushLoop
+
+// ================================================================================================
+
+bool  CheckpointWriter::writeSnapshot ( )
+  {
+  std::string   temporary  =  fileName + ".tmp" ;
+  std::FILE *   file       =  std::fopen ( temporary.c_str(), "wb" ) ;
+  if ( file == 0 )
+    return  false ;
+
+  uint64_t  checksum  =  FNV_OFFSET ;
+  bool  ok  =  writeHashed ( file, checksum, &header[0], header.size() )
+            && writeHashed ( file, checksum, &flushStep, sizeof(flushStep) )
+            && writeHashed ( file, checksum, flushState.data(), N * sizeof(double) ) ;
+  if ( ok && embedOperators )
+    {
+    ok  =  writeHashed ( file, checksum, propagator->data(), propagator->size() * sizeof(double) ) ;
+    if ( ok && forcing )
+      ok  =  writeHashed ( file, checksum, forcing->data(), forcing->size() * sizeof(double) ) ;
+    } // end if
+  ok  =  ok && ( std::fwrite ( &checksum, sizeof(checksum), 1, file ) == 1 ) && syncToDisk ( file ) ;
+  if ( std::fclose ( file ) != 0 )
+    ok  =  false ;
+
+  ok  =  ok && replaceFile ( temporary, fileName ) ;
+  if ( ! ok )
+    std::remove ( temporary.c_str() ) ;  //  the previous checkpoint, if any, is untouched
+  return  ok ;
+  } // end writeSnapshot
+
+// ================================================================================================
+
+void  CheckpointWriter::close ( )
+  {
+  if ( ! flusher.joinable() )
+    return ;  //  already closed
+  std::unique_lock<std::mutex>  lock ( snapshotMutex ) ;
+  closing  =  true ;
+  snapshotChanged.notify_all ( ) ;
+  lock.unlock ( ) ;
+  flusher.join ( ) ;
+  } // end close
+
+// ================================================================================================
+
+bool  CheckpointWriter::good ( ) const
+  {
+  std::lock_guard<std::mutex>  lock ( snapshotMutex ) ;
+  return  ! failed ;
+  } // end good
+
+// ================================================================================================
+
+uint64_t  CheckpointWriter::lastWritten ( ) const
+  {
+  std::lock_guard<std::mutex>  lock ( snapshotMutex ) ;
+  return  writtenStep ;
+  } // end lastWritten
+
+// ================================================================================================
+
+// constructor
+CheckpointReader::CheckpointReader ( const std::string & fileName )
+  : valid ( false ), order ( 0 ), N ( 0 ), periodic ( false ), xMin ( 0.0 ), xMax ( 0.0 ), dt ( 0.0 ),
+    forcingColumns ( 0 ), embedded ( false ), propagatorHash ( 0 ), forcingHash ( 0 ), steps ( 0 )
+  {
+  // Read the whole file; it holds one state (and perhaps the operators), so it is small.
+  std::vector<char>  buffer ;
+  std::FILE *  file  =  std::fopen ( fileName.c_str(), "rb" ) ;
+  if ( file == 0 )
+    return ;
+  char    chunk [ 65536 ] ;
+  size_t  count ;
+  while ( (count = std::fread ( chunk, 1, sizeof(chunk), file )) > 0 )
+    buffer.insert ( buffer.end(), chunk, chunk + count ) ;
+  std::fclose ( file ) ;
+
+  // The trailing checksum covers everything before it.
+  uint64_t  checksum ;
+  if ( buffer.size() < sizeof(MAGIC) + sizeof(checksum) )
+    return ;
+  size_t  size  =  buffer.size() - sizeof(checksum) ;
+  std::memcpy ( &checksum, &buffer[size], sizeof(checksum) ) ;
+  if ( (std::memcmp ( &buffer[0], MAGIC, sizeof(MAGIC) ) != 0)
+       || (hashBytes ( FNV_OFFSET, &buffer[0], size ) != checksum) )
+    return ;
+
+  // Read & validate the header.
+  size_t    offset  =  sizeof(MAGIC) ;
+  uint32_t  version, order32 ;
+  uint64_t  N64, numKnots, rows, cols, periodic64, forcing64, embedded64 ;
+  bool  ok  =  extract ( buffer, size, offset, version ) && ( version == VERSION )
+            && extract ( buffer, size, offset, order32 )
+            && extract ( buffer, size, offset, N64 )
+            && extract ( buffer, size, offset, numKnots )
+            && extract ( buffer, size, offset, rows )
+            && extract ( buffer, size, offset, cols )
+            && extract ( buffer, size, offset, periodic64 )
+            && extract ( buffer, size, offset, xMin )
+            && extract ( buffer, size, offset, xMax )
+            && extract ( buffer, size, offset, dt )
+            && extract ( buffer, size, offset, forcing64 )
+            && extract ( buffer, size, offset, embedded64 )
+            && extract ( buffer, size, offset, propagatorHash )
+            && extract ( buffer, size, offset, forcingHash ) ;
+  if ( ok )
+    ok  =  ( offset + (numKnots + N64) * sizeof(double) + rows * cols * sizeof(int32_t) <= size ) ;
+  if ( ! ok )
+    return ;
+
+  order           =  order32 ;
+  N               =  N64 ;
+  periodic        =  ( periodic64 != 0 ) ;
+  forcingColumns  =  forcing64 ;
+  embedded        =  ( embedded64 != 0 ) ;
+  knotX.resize ( numKnots ) ;
+  extractArray ( buffer, size, offset, knotX.data(), numKnots ) ;
+  collocationX.resize ( N ) ;
+  extractArray ( buffer, size, offset, collocationX.data(), N ) ;
+  K_matrix.resize ( rows, cols ) ;
+  for ( size_t r = 0 ; r < rows ; r ++ )
+    for ( size_t p = 0 ; p < cols ; p ++ )
+      {
+      int32_t  k  =  0 ;
+      extract ( buffer, size, offset, k ) ;
+      K_matrix ( r, p )  =  k ;
+      }
+  offset  =  roundUpTo8 ( offset ) ;
+
+  // The state, then the operators if embedded.
+  u.resize ( N ) ;
+  ok  =  extract ( buffer, size, offset, steps ) && extractArray ( buffer, size, offset, u.data(), N ) ;
+  if ( ok && embedded )
+    {
+    std::shared_ptr<Eigen::MatrixXd>  P  =  std::make_shared<Eigen::MatrixXd> ( N, N ) ;
+    ok  =  extractArray ( buffer, size, offset, P->data(), P->size() ) ;
+    propagator  =  P ;
+    if ( ok && (forcingColumns > 0) )
+      {
+      std::shared_ptr<Eigen::MatrixXd>  G  =  std::make_shared<Eigen::MatrixXd> ( N, forcingColumns ) ;
+      ok  =  extractArray ( buffer, size, offset, G->data(), G->size() ) ;
+      forcing  =  G ;
+      } // end if
+    } // end if
+  valid  =  ok && ( offset == size ) ;
+  } // end constructor
+
+// ================================================================================================
+
+SplinePtr  CheckpointReader::spline ( ) const
+  {
+  assert ( valid ) ;
+  if ( periodic )
+    return  Spline::create ( order, xMin, xMax, N ) ;
+  // The recorded points reproduce the original collocation, whatever strategy placed them.
+  return  Spline::create ( order, knotX, K_matrix, CollocationStrategy::fixed ( collocationX ) ) ;
+  } // end spline
+
+// ================================================================================================
+
+bool  CheckpointReader::matches ( const Eigen::MatrixXd & propagator, const Eigen::MatrixXd * forcing ) const
+  {
+  if ( CheckpointWriter::operatorHash ( propagator ) != propagatorHash )
+    return  false ;
+  return  ( forcing == 0 ) || ( CheckpointWriter::operatorHash ( *forcing ) == forcingHash ) ;
+  } // end matches
+
+// ================================================================================================
+
+std::shared_ptr<Stepper>  CheckpointReader::resume ( ) const
+  {
+  if ( ! (valid && embedded) )
+    return  std::shared_ptr<Stepper> ( ) ;
+  return  resume ( propagator, forcing ) ;
+  } // end resume
+
+// ================================================================================================
+
+std::shared_ptr<Stepper>  CheckpointReader::resume ( std::shared_ptr<const Eigen::MatrixXd> propagator,
+                                                     std::shared_ptr<const Eigen::MatrixXd> forcing ) const
+  {
+  // A mismatch is reported, not asserted, so that a release build never restarts the wrong run.
+  bool  ok  =  valid && propagator
+               && ( static_cast<size_t>(propagator->rows()) == N ) && ( static_cast<size_t>(propagator->cols()) == N )
+               && ( static_cast<bool>(forcing) == (forcingColumns > 0) )
+               && ( ! forcing || ( (static_cast<size_t>(forcing->rows()) == N)
+                                   && (static_cast<size_t>(forcing->cols()) == forcingColumns) ) )
+               && matches ( *propagator, forcing.get() ) ;
+  if ( ! ok )
+    return  std::shared_ptr<Stepper> ( ) ;
+  std::shared_ptr<Stepper>  stepper  =  forcing ? std::make_shared<Stepper> ( propagator, forcing, u )
+                                                : std::make_shared<Stepper> ( propagator, u ) ;
+  stepper->reset ( u, steps ) ;
+  return  stepper ;
+  } // end resume
+
+// ================================================================================================
@@ -0,0 +1,288 @@
+/**
+ * @file    Checkpoint.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File Checkpoint.h contains the declarations of the CheckpointWriter and
+ * CheckpointReader classes, which save &amp; restore the state of a BSCM time loop.
+ */
+
+#ifndef  CHECKPOINT_H
+#define  CHECKPOINT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include <Eigen/Dense>
+#include "Spline.h"
+#include "Stepper.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %CheckpointWriter saves the state of a Stepper to a file, from which
+   * CheckpointReader resumes the run.
+   *
+   * The file begins with a description of the %Spline
+   * (magic "BSCMCP01", then, as native-endian fields:
+   * uint32 version, uint32 order <b><em>M</em></b>, uint64 <b><em>N</em></b>,
+   * uint64 numKnots, uint64 rows &amp; uint64 columns of <b><em>K_matrix</em></b>,
+   * uint64 periodic flag, double <em>xMin</em>, double <em>xMax</em>, double <em>dt</em>,
+   * uint64 columns of the forcing matrix (0 if none), uint64 embedded flag,
+   * uint64 hashes of the propagator &amp; of the forcing matrix,
+   * the knots, the <b><em>N</em></b> collocation points, and <b><em>K_matrix</em></b> as int32 in row-major order,
+   * padded with zeros to a multiple of 8 bytes).
+   * Then follow the uint64 step count, the <b><em>N</em></b> collocation values,
+   * the propagator &amp; forcing matrices (column-major) if they are embedded, and a
+   * uint64 checksum of everything before it.\n\n
+   * <b><em>save</em></b> only copies the state into a snapshot buffer and returns;
+   * a background thread writes the snapshot to "<em>fileName</em>.tmp", flushes it to the disk,
+   * and renames it over <em>fileName</em>, so that <em>fileName</em> always holds a complete
+   * checkpoint, however the run ends.  If the thread is still writing when the next
+   * <b><em>save</em></b> comes, the newer snapshot replaces any one not yet started.\n
+   * The operators are held through shared pointers and never copied; the hashes let a
+   * restart verify that operators recomputed from the %Spline are bit for bit those
+   * of the original run, and embedding them makes the restart independent of the %Spline.
+   */
+
+  class  CheckpointWriter
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Prepare to checkpoint a run to <em>fileName</em>
+        *
+        * @param fileName        Checkpoint file; "<em>fileName</em>.tmp" is used while writing
+        * @param spline          %Spline of the run
+        * @param dt              Time step
+        * @param propagator      Propagator matrix of the run's Stepper
+        * @param forcing         Forcing matrix of the run's Stepper, or empty
+        * @param embedOperators  Whether to write the matrices themselves, not only their hashes
+        */
+      CheckpointWriter ( const std::string & fileName, const Spline & spline, double dt,
+                         std::shared_ptr<const Eigen::MatrixXd> propagator,
+                         std::shared_ptr<const Eigen::MatrixXd> forcing = std::shared_ptr<const Eigen::MatrixXd>(),
+                         bool embedOperators = false ) ;
+
+      /**
+        * @brief
+        * Equivalent to <b><em>close</em></b>
+        */
+      ~CheckpointWriter ( ) ;
+
+      /**
+        * @brief
+        * Checkpoint the collocation values <em>u</em> after <em>step</em> steps
+        *
+        * Copies <em>u</em> and returns without waiting for the file to be written.
+        */
+      void  save ( uint64_t step, const Eigen::VectorXd & u ) ;
+
+      /**
+        * @brief
+        * Checkpoint the state &amp; step count of <em>stepper</em>
+        */
+      void  save ( const Stepper & stepper )  { save ( stepper.stepCount(), stepper.state() ) ; }
+
+      /**
+        * @brief
+        * Write the latest snapshot, if not yet written, and stop the background thread
+        */
+      void  close ( ) ;
+
+      /**
+        * @brief
+        * false once any checkpoint has failed to be written
+        */
+      bool  good ( ) const ;
+
+      /**
+        * @brief
+        * Step count of the latest checkpoint known to be complete on the disk
+        * (0 before the first)
+        */
+      uint64_t  lastWritten ( ) const ;
+
+      /**
+        * @brief
+        * 64-bit FNV-1a hash of the dimensions &amp; elements of <em>A</em>
+        *
+        * @return  uint64_t
+        */
+      static uint64_t  operatorHash ( const Eigen::MatrixXd & A ) ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      CheckpointWriter ( const CheckpointWriter & ) ;              // not copyable
+      CheckpointWriter &  operator= ( const CheckpointWriter & ) ; // not assignable
+
+      std::string  fileName ;
+      size_t       N ;
+      bool         embedOperators ;
+      std::vector<char>                       header ;
+      std::shared_ptr<const Eigen::MatrixXd>  propagator ;
+      std::shared_ptr<const Eigen::MatrixXd>  forcing ;
+
+      /**
+        * The snapshot filled by <b><em>save</em></b>, and the snapshot being written to the file.
+        */
+      Eigen::VectorXd  fillState ;
+      Eigen::VectorXd  flushState ;
+      uint64_t         fillStep ;
+      uint64_t         flushStep ;
+
+      /**
+        * Guards fillState, fillStep, snapshotPending, closing, failed &amp; writtenStep.
+        */
+      mutable std::mutex       snapshotMutex ;
+      std::condition_variable  snapshotChanged ;
+      bool                     snapshotPending ;
+      bool                     closing ;
+      bool                     failed ;
+      uint64_t                 writtenStep ;
+      std::thread              flusher ;
+
+      /**
+        * Body of the background thread.
+        */
+      void  flushLoop ( ) ;
+
+      /**
+        * Write flushState to the temporary file and rename it over fileName.
+        */
+      bool  writeSnapshot ( ) ;
+
+    } ; // end CheckpointWriter class
+
+  /**
+   * @brief
+   * Class %CheckpointReader reads a file written by CheckpointWriter and resumes
+   * the run it describes.
+   *
+   * A restarted Stepper applies the same matrices to the same values in the same order,
+   * so it continues bit for bit as the uninterrupted run would have.
+   */
+
+  class  CheckpointReader
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Read <em>fileName</em>
+        *
+        * If the file cannot be read, is not a BSCM checkpoint, or fails its checksum,
+        * <b><em>good</em></b> returns false.
+        */
+      explicit CheckpointReader ( const std::string & fileName ) ;
+
+      /** @brief true if the file was read and is a complete checkpoint */
+      bool  good ( ) const  { return  valid ; }
+
+      /** @brief Number of steps taken when the checkpoint was saved */
+      uint64_t  stepCount ( ) const  { return  steps ; }
+
+      /** @brief Collocation values when the checkpoint was saved */
+      const Eigen::VectorXd &  state ( ) const  { return  u ; }
+
+      /** @brief Time step */
+      double  getDt ( ) const  { return  dt ; }
+
+      /** @brief %Spline order <b><em>M</em></b> */
+      size_t  getOrder ( ) const  { return  order ; }
+
+      /** @brief Number of collocation points <b><em>N</em></b> */
+      size_t  getN ( ) const  { return  N ; }
+
+      /** @brief Sequence of knot points */
+      const std::vector<double> &  getKnotX ( ) const  { return  knotX ; }
+
+      /** @brief Collocation points of the %Spline */
+      const std::vector<double> &  getCollocationX ( ) const  { return  collocationX ; }
+
+      /** @brief Boundary conditions (empty for a periodic %Spline) */
+      const Eigen::MatrixXi &  getK_matrix ( ) const  { return  K_matrix ; }
+
+      /** @brief Whether the %Spline was periodic */
+      bool  isPeriodic ( ) const  { return  periodic ; }
+
+      /** @brief Whether the propagator (&amp; forcing) matrices are in the file */
+      bool  hasEmbeddedOperators ( ) const  { return  embedded ; }
+
+      /**
+        * @brief
+        * A %Spline constructed as the run's was
+        *
+        * @return  SplinePtr
+        */
+      SplinePtr  spline ( ) const ;
+
+      /**
+        * @brief
+        * Whether <em>propagator</em> &amp; <em>forcing</em> hash to the values recorded
+        * for the run's matrices
+        */
+      bool  matches ( const Eigen::MatrixXd & propagator,
+                      const Eigen::MatrixXd * forcing = 0 ) const ;
+
+      /**
+        * @brief
+        * A Stepper continuing the run, with the embedded matrices
+        *
+        * @return  std::shared_ptr<Stepper>, empty unless the checkpoint is <b><em>good</em></b>
+        *          and <b><em>hasEmbeddedOperators</em></b>
+        */
+      std::shared_ptr<Stepper>  resume ( ) const ;
+
+      /**
+        * @brief
+        * A Stepper continuing the run, with recomputed matrices
+        *
+        * @param propagator  Propagator matrix, e.g. from Stepper::heatPropagator
+        * @param forcing     Forcing matrix, if the run had one
+        * @return  std::shared_ptr<Stepper>, empty unless the checkpoint is <b><em>good</em></b>,
+        *          the matrices have the run's dimensions, and they <b><em>match</em></b> those of the run
+        */
+      std::shared_ptr<Stepper>  resume ( std::shared_ptr<const Eigen::MatrixXd> propagator,
+                                         std::shared_ptr<const Eigen::MatrixXd> forcing = std::shared_ptr<const Eigen::MatrixXd>() ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      bool      valid ;
+      size_t    order ;
+      size_t    N ;
+      bool      periodic ;
+      double    xMin ;
+      double    xMax ;
+      double    dt ;
+      size_t    forcingColumns ;  //  0 if the run had no forcing matrix
+      bool      embedded ;
+      uint64_t  propagatorHash ;
+      uint64_t  forcingHash ;
+      uint64_t  steps ;
+      std::vector<double>  knotX ;
+      std::vector<double>  collocationX ;
+      Eigen::MatrixXi      K_matrix ;
+      Eigen::VectorXd      u ;
+      std::shared_ptr<const Eigen::MatrixXd>  propagator ;  //  empty unless embedded
+      std::shared_ptr<const Eigen::MatrixXd>  forcing ;     //  empty unless embedded, and the run had one
+
+    } ; // end CheckpointReader class
+
+  } // end namespace BSCM
+
+#endif  //  CHECKPOINT_H
@@ -0,0 +1,171 @@
+/**
+ * @file    CollocationStrategy.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File CollocationStrategy.cpp contains the definition of the CollocationStrategy class,
+ * which places the collocation points of a Spline.
+ */
+
+#include <cassert>
+#include <cmath>
+#include "CollocationStrategy.h"
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor
+CollocationStrategy::CollocationStrategy ( Rule rule, const std::string & name )
+  : rule ( rule ), name ( name )
+  {
+  assert ( rule ) ;
+  } // end constructor
+
+// ================================================================================================
+
+CollocationStrategy  CollocationStrategy::midpoint ( )
+  {
+  return  CollocationStrategy ( [] ( size_t order, const std::vector<double> & knotX )
+    {
+    std::vector<double>  x ;
+    for ( size_t j = order - 1 ; j + order < knotX.size() ; j ++ )
+      x.push_back ( (knotX[j] + knotX[j+1]) / 2 ) ;
+    return  x ;
+    }, "midpoint" ) ;
+  } // end midpoint
+
+// ================================================================================================
+
+CollocationStrategy  CollocationStrategy::greville ( )
+  {
+  return  CollocationStrategy ( [] ( size_t order, const std::vector<double> & knotX )
+    {
+    // Basis function i has support [ knotX[i], knotX[i+M] ]; its Greville abscissa is the
+    // average of the M-1 knots strictly inside.  The first & last (M-1)/2 are left out.
+    const size_t  q  =  ( order - 1 ) / 2 ;
+    const size_t  N  =  knotX.size() + 1 - 2 * order ;
+    std::vector<double>  x ;
+    for ( size_t i = q ; i < q + N ; i ++ )
+      {
+      double  sum  =  0.0 ;
+      for ( size_t k = 1 ; k < order ; k ++ )
+        sum  +=  knotX[i+k] ;
+      x.push_back ( sum / (order - 1) ) ;
+      } // end for i loop
+    return  x ;
+    }, "greville" ) ;
+  } // end greville
+
+// ================================================================================================
+
+CollocationStrategy  CollocationStrategy::gaussLegendre ( )
+  {
+  return  CollocationStrategy ( [] ( size_t order, const std::vector<double> & knotX )
+    {
+    const size_t  N     =  knotX.size() + 1 - 2 * order ;
+    const double  xMin  =  knotX [ order - 1 ] ;
+    const double  xMax  =  knotX [ knotX.size() - order ] ;
+    std::vector<double>  x  =  legendreZeros ( N ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      x[alpha]  =  xMin + 0.5 * ( x[alpha] + 1.0 ) * ( xMax - xMin ) ;
+    return  x ;
+    }, "gauss" ) ;
+  } // end gaussLegendre
+
+// ================================================================================================
+
+CollocationStrategy  CollocationStrategy::fixed ( const std::vector<double> & points )
+  {
+  return  CollocationStrategy ( [points] ( size_t, const std::vector<double> & )
+    {
+    return  points ;
+    }, "fixed" ) ;
+  } // end fixed
+
+// ================================================================================================
+
+bool  CollocationStrategy::schoenbergWhitney ( size_t order, const std::vector<double> & knotX,
+                                               const std::vector<double> & points )
+  {
+  if ( knotX.size() < 2 * order )
+    return  false ;
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  const size_t  N  =  knotX.size() + 1 - 2 * order ;
+  if ( points.size() != N )
+    return  false ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    double  x  =  points[alpha] ;
+    if ( (alpha > 0) && ! (points[alpha-1] < x) )
+      return  false ;
+    if ( ! ( (knotX[order-1] <= x) && (x < knotX[knotX.size()-order]) ) )
+      return  false ;
+    if ( ! ( (knotX[q+alpha] < x) && (x < knotX[q+alpha+order]) ) )
+      return  false ;
+    } // end for alpha loop
+  return  true ;
+  } // end schoenbergWhitney
+
+// ================================================================================================
+
+std::vector<double>  CollocationStrategy::legendreZeros ( size_t N )
+  {
+  // Newton's method on P_N, from the asymptotic estimate of each zero;
+  // the zeros are symmetric, so only half are computed.
+  const double  PI  =  4.0 * std::atan ( 1.0 ) ;
+  std::vector<double>  x ( N ) ;
+  for ( size_t k = 0 ; k < (N + 1) / 2 ; k ++ )
+    {
+    double  z  =  std::cos ( PI * (k + 0.75) / (N + 0.5) ) ;
+    for ( int iteration = 0 ; iteration < 100 ; iteration ++ )
+      {
+      // P_N(z) by the three-term recurrence, and P_N'(z) from P_N & P_(N-1).
+      double  p0  =  1.0, p1  =  z ;
+      for ( size_t n = 2 ; n <= N ; n ++ )
+        {
+        double  p2  =  ( (2*n - 1) * z * p1 - (n - 1) * p0 ) / n ;
+        p0  =  p1 ;
+        p1  =  p2 ;
+        } // end for n loop
+      if ( N == 1 )
+        p0  =  1.0 ;
+      double  derivative  =  N * ( z * p1 - p0 ) / ( z * z - 1.0 ) ;
+      double  step        =  p1 / derivative ;
+      z  -=  step ;
+      if ( std::abs ( step ) < 1.0e-15 )
+        break ;
+      } // end for iteration loop
+    x [ k ]          =  - z ;
+    x [ N - 1 - k ]  =    z ;
+    } // end for k loop
+  return  x ;
+  } // end legendreZeros
+
+// ================================================================================================
+
+std::vector<double>  CollocationStrategy::gaussLegendreKnots ( size_t order, double xMin, double xMax, size_t N )
+  {
+  assert ( (N >= 1) && (xMin < xMax) ) ;
+  std::vector<double>  x  =  legendreZeros ( N ) ;
+  std::vector<double>  knotX ( N + 2 * order - 1 ) ;
+  knotX [ order - 1 ]      =  xMin ;
+  knotX [ order - 1 + N ]  =  xMax ;
+  for ( size_t alpha = 1 ; alpha < N ; alpha ++ )
+    knotX [ order - 1 + alpha ]  =  xMin + 0.25 * ( x[alpha-1] + x[alpha] + 2.0 ) * ( xMax - xMin ) ;
+  double  hLeft   =  knotX [ order ] - xMin ;
+  double  hRight  =  xMax - knotX [ order - 2 + N ] ;
+  for ( size_t j = 1 ; j < order ; j ++ )
+    {
+    knotX [ order - 1 - j ]      =  xMin - j * hLeft ;
+    knotX [ order - 1 + N + j ]  =  xMax + j * hRight ;
+    } // end for j loop
+  return  knotX ;
+  } // end gaussLegendreKnots
+
+// ================================================================================================
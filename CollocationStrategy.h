@@ -0,0 +1,143 @@
+/**
+ * @file    CollocationStrategy.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File CollocationStrategy.h contains the declaration of the CollocationStrategy class,
+ * which places the collocation points of a Spline.
+ */
+
+#ifndef  COLLOCATIONSTRATEGY_H
+#define  COLLOCATIONSTRATEGY_H
+
+#include <vector>
+#include <string>
+#include <functional>
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %CollocationStrategy chooses the <b><em>N</em></b> collocation points of a %Spline
+   * from its order and knots.
+   *
+   * The built-in strategies are
+   * <ul>
+   * <li> <b><em>midpoint</em></b>:&nbsp; the midpoint of each knot interval of the physical region
+   *      (Umar's Equation (13), p. 431);</li>
+   * <li> <b><em>greville</em></b>:&nbsp; the Greville abscissae (averages of
+   *      <b><em>M</em></b>&minus;1 consecutive knots) of the basis functions
+   *      <em>B<sub>&nbsp;i</sub><sup>M</sup></em>, <em>i</em> = (<b><em>M</em></b>&minus;1)/2, ...,
+   *      leaving out the (<b><em>M</em></b>&minus;1)/2 at each end, whose places are taken by the
+   *      boundary conditions;</li>
+   * <li> <b><em>gaussLegendre</em></b>:&nbsp; the zeros of the Legendre polynomial of degree
+   *      <b><em>N</em></b>, mapped onto [&nbsp;<em>xMin</em>, <em>xMax</em>&nbsp;]; these cluster toward the
+   *      boundaries, so the knots should be graded to match (see <b><em>gaussLegendreKnots</em></b>).
+   *      These are the zeros of one global polynomial, adapted to a spline with one point per knot
+   *      interval:&nbsp; they pass the Schoenberg&ndash;Whitney condition only on
+   *      <b><em>gaussLegendreKnots</em></b>, and they do not reach the accuracy of <b><em>midpoint</em></b>
+   *      with fewer points, as Gauss points of each interval would; on graded knots all three
+   *      strategies give about the same error;</li>
+   * <li> <b><em>fixed</em></b>:&nbsp; points given in advance.</li>
+   * </ul>
+   * Any other rule may be given to the constructor.\n\n
+   * Whatever the rule, the points must satisfy the Schoenberg&ndash;Whitney condition
+   * for the system of Umar's Equation (20), p. 433:&nbsp; they must increase strictly, lie in
+   * [&nbsp;<em>xMin</em>, <em>xMax</em>&nbsp;), and point &alpha; must lie inside the support of
+   * <em>B<sub>&nbsp;i</sub><sup>M</sup></em> for <em>i</em> = &alpha; + (<b><em>M</em></b>&minus;1)/2,
+   * the basis function on the diagonal of "B tilde".  This keeps "B tilde" nonsingular
+   * for suitable boundary conditions, and banded with <b><em>M</em></b>&minus;1 diagonals
+   * on each side.
+   */
+
+  class  CollocationStrategy
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Function returning the collocation points for a %Spline order &amp; knots
+        */
+      typedef  std::function< std::vector<double> ( size_t order, const std::vector<double> & knotX ) >  Rule ;
+
+      /**
+        * @brief
+        * A strategy following <em>rule</em>
+        *
+        * @param rule  Function returning the collocation points
+        * @param name  Name by which the strategy is reported
+        */
+      explicit CollocationStrategy ( Rule rule, const std::string & name = "custom" ) ;
+
+      /** @brief Midpoints of the knot intervals (the default) */
+      static CollocationStrategy  midpoint ( ) ;
+
+      /** @brief Greville abscissae of the interior basis functions */
+      static CollocationStrategy  greville ( ) ;
+
+      /** @brief Gauss&ndash;Legendre points of the physical region */
+      static CollocationStrategy  gaussLegendre ( ) ;
+
+      /** @brief The given <em>points</em>, whatever the knots */
+      static CollocationStrategy  fixed ( const std::vector<double> & points ) ;
+
+      /**
+        * @brief
+        * Collocation points for a %Spline of order <em>order</em> with knots <em>knotX</em>
+        *
+        * @return  std::vector<double>
+        */
+      std::vector<double>  points ( size_t order, const std::vector<double> & knotX ) const
+        { return  rule ( order, knotX ) ; }
+
+      /** @brief Name of the strategy */
+      const std::string &  getName ( ) const  { return  name ; }
+
+      /**
+        * @brief
+        * Whether <em>points</em> satisfy the Schoenberg&ndash;Whitney condition
+        * for order <em>order</em> &amp; knots <em>knotX</em>
+        *
+        * @return  bool
+        */
+      static bool  schoenbergWhitney ( size_t order, const std::vector<double> & knotX,
+                                       const std::vector<double> & points ) ;
+
+      /**
+        * @brief
+        * Zeros of the Legendre polynomial of degree <em>N</em>, in increasing order on
+        * [&nbsp;&minus;1, 1&nbsp;]
+        *
+        * @return  std::vector<double>
+        */
+      static std::vector<double>  legendreZeros ( size_t N ) ;
+
+      /**
+        * @brief
+        * Knots for <b><em>gaussLegendre</em></b> collocation:&nbsp; <em>N</em> intervals between
+        * <em>xMin</em> &amp; <em>xMax</em>, each holding one Gauss&ndash;Legendre point
+        *
+        * The interior knots lie midway between consecutive points; the
+        * <em>order</em>&nbsp;&minus;&nbsp;1 knots beyond each boundary continue the spacing
+        * of the outermost interval.
+        * @return  std::vector<double>  of <em>N</em> + 2&nbsp;<em>order</em> &minus; 1 knots
+        */
+      static std::vector<double>  gaussLegendreKnots ( size_t order, double xMin, double xMax, size_t N ) ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      Rule         rule ;
+      std::string  name ;
+
+    } ; // end CollocationStrategy class
+
+  } // end namespace BSCM
+
+#endif  //  COLLOCATIONSTRATEGY_H
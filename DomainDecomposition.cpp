@@ -0,0 +1,299 @@
+/**
+ * @file    DomainDecomposition.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File DomainDecomposition.cpp contains the definition of the DomainDecomposition class,
+ * which solves large BSCM boundary value problems on overlapping subdomains.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <new>
+#include <limits>
+#include "DomainDecomposition.h"
+
+#ifdef _WIN32
+  #include <vector>
+#else
+  #include <unistd.h>
+  #include <signal.h>
+  #include <cerrno>
+  #include <sys/mman.h>
+  #include <sys/wait.h>
+#endif
+
+using namespace BSCM ;
+
+namespace
+  {
+  // A barrier usable by threads, or by processes sharing the memory it lives in:
+  // lock-free atomics work on any mapping of the same physical memory.
+  struct  SpinBarrier
+    {
+    std::atomic<size_t>  arrived ;
+    std::atomic<size_t>  generation ;
+    size_t               parties ;
+
+    // Returns false if *aborted became nonzero while waiting.
+    bool  wait ( const std::atomic<int> & aborted )
+      {
+      size_t  myGeneration  =  generation.load ( ) ;
+      if ( arrived.fetch_add ( 1 ) + 1 == parties )
+        {
+        arrived.store ( 0 ) ;
+        generation.fetch_add ( 1 ) ;
+        return  true ;
+        } // end if
+      while ( generation.load ( ) == myGeneration )
+        {
+        if ( aborted.load ( ) != 0 )
+          return  false ;
+        std::this_thread::yield ( ) ;
+        } // end while
+      return  true ;
+      } // end wait
+    } ; // end SpinBarrier struct
+  } // end anonymous namespace
+
+// Placed at the start of the shared memory; the arrays follow it in the same mapping,
+// which is created before any subdomain starts, so the pointers are valid in every subdomain.
+struct  DomainDecomposition::SharedState
+  {
+  SpinBarrier       barrier ;
+  std::atomic<int>  aborted ;
+  size_t            iterations ;      //  written by subdomain 0
+  int               converged ;       //  written by subdomain 0
+  double *          interfaceValues ; //  [parity][subdomain][left/right][derivative]
+  double *          changes ;         //  [parity][subdomain]
+  double *          solution ;        //  [N]
+  } ; // end SharedState struct
+
+// ================================================================================================
+
+// constructor
+DomainDecomposition::DomainDecomposition ( size_t order, double xMin, double xMax, size_t N,
+                                           Eigen::MatrixXi K_matrix, size_t numSubdomains, size_t overlap )
+  : order ( order ), xMin ( xMin ), h ( (xMax - xMin) / N ), N ( N ), K_matrix ( K_matrix ),
+    lastIterations ( 0 ), lastConverged ( false )
+  {
+  assert ( (order % 2) == 1 ) ;
+  assert ( (K_matrix.rows() == static_cast<int>(order - 1)) && (K_matrix.cols() == static_cast<int>(order)) ) ;
+  assert ( (numSubdomains >= 1) && (xMin < xMax) ) ;
+  assert ( (overlap >= 1) || (numSubdomains == 1) ) ;
+
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    collocationX.push_back ( xMin + ( alpha + 0.5 ) * h ) ;
+
+  for ( size_t s = 0 ; s < numSubdomains ; s ++ )
+    {
+    Subdomain  sd ;
+    sd.ownedFirst  =  ( s * N ) / numSubdomains ;
+    sd.ownedCount  =  ( (s + 1) * N ) / numSubdomains - sd.ownedFirst ;
+    // Each interface must lie strictly inside the neighbouring subdomain.
+    assert ( (sd.ownedCount > overlap) || (numSubdomains == 1) ) ;
+    sd.first  =  ( sd.ownedFirst > overlap ) ? ( sd.ownedFirst - overlap ) : 0 ;
+    sd.count  =  std::min ( N, sd.ownedFirst + sd.ownedCount + overlap ) - sd.first ;
+    subdomains.push_back ( sd ) ;
+    } // end for s loop
+  } // end constructor
+
+// ================================================================================================
+
+void  DomainDecomposition::runSubdomain ( size_t s, const Eigen::VectorXd & f, double shift, double diffusivity,
+                                          double tolerance, size_t maxIterations, SharedState & shared ) const
+  {
+  const Subdomain &  sd  =  subdomains[s] ;
+  const size_t  S         =  subdomains.size() ;
+  const size_t  q         =  ( order - 1 ) / 2 ;  //  rows per side
+  const bool    leftEdge  =  ( sd.first == 0 ) ;
+  const bool    rightEdge =  ( sd.first + sd.count == N ) ;
+
+  // Uniform knots of the subdomain, continuing the global knot spacing.
+  std::vector<double>  knotX ;
+  for ( size_t j = 0 ; j < (sd.count + 2*order - 1) ; j ++ )
+    knotX.push_back ( xMin + ( static_cast<double>(sd.first + j) - static_cast<double>(order - 1) ) * h ) ;
+
+  // Global boundary rows at physical boundaries; at an interface, row r fixes derivative r.
+  Eigen::MatrixXi  K  =  Eigen::MatrixXi::Zero ( order - 1, order ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    {
+    if ( leftEdge )   K.row(r)      =  K_matrix.row(r) ;      else  K ( r,     r )  =  1 ;
+    if ( rightEdge )  K.row(q + r)  =  K_matrix.row(q + r) ;  else  K ( q + r, r )  =  1 ;
+    } // end for r loop
+  Spline  spline ( order, knotX, K ) ;
+
+  // With boundary-row values g, the second derivative at the collocation points is
+  // O u + L g, so the subdomain equation is  (shift - kappa O) u = f + kappa L g.
+  Eigen::MatrixXd  A  =  - diffusivity * spline.operatorMatrix(2) ;
+  A.diagonal().array()  +=  shift ;
+  Eigen::PartialPivLU<Eigen::MatrixXd>  solver ( A ) ;
+  Eigen::MatrixXd  L  =  spline.liftingMatrix ( 2 ) ;
+
+  // Interface points of the neighbours, which lie inside this subdomain.
+  double  leftNeighbourX   =  ( s > 0 )     ? ( xMin + (subdomains[s-1].first + subdomains[s-1].count) * h ) : 0.0 ;
+  double  rightNeighbourX  =  ( s + 1 < S ) ? ( xMin + subdomains[s+1].first * h ) : 0.0 ;
+
+  Eigen::VectorXd  fLocal  =  f.segment ( sd.first, sd.count ) ;
+  Eigen::VectorXd  u       =  Eigen::VectorXd::Zero ( sd.count ) ;
+  Eigen::VectorXd  g       =  Eigen::VectorXd::Zero ( order - 1 ) ;
+  bool    converged  =  false ;
+  size_t  iteration  =  0 ;
+
+  // Iteration `it` reads interface values of parity (it % 2) and writes the other parity,
+  // so no subdomain overwrites values that another may still be reading.
+  while ( (iteration < maxIterations) && ! converged )
+    {
+    size_t   parity  =  iteration % 2 ;
+    double * mine    =  shared.interfaceValues + ( (parity * S + s) * 2 ) * q ;
+    if ( ! leftEdge )
+      g.head(q)  =  Eigen::Map<Eigen::VectorXd> ( mine, q ) ;
+    if ( ! rightEdge )
+      g.tail(q)  =  Eigen::Map<Eigen::VectorXd> ( mine + q, q ) ;
+
+    Eigen::VectorXd  uNew    =  solver.solve ( fLocal + diffusivity * ( L * g ) ) ;
+    double           scale   =  std::max ( uNew.cwiseAbs().maxCoeff(), std::numeric_limits<double>::min() ) ;
+    shared.changes[ parity * S + s ]  =  ( uNew - u ).cwiseAbs().maxCoeff() / scale ;
+    u  =  uNew ;
+
+    Eigen::VectorXd  c  =  spline.coefficients ( u, g ) ;
+    size_t  next  =  1 - parity ;
+    for ( size_t p = 0 ; p < q ; p ++ )
+      {
+      if ( s > 0 )      //  right interface of the left neighbour
+        shared.interfaceValues[ ((next * S + s - 1) * 2 + 1) * q + p ]  =  spline.evaluate ( c, p, leftNeighbourX ) ;
+      if ( s + 1 < S )  //  left interface of the right neighbour
+        shared.interfaceValues[ ((next * S + s + 1) * 2) * q + p ]  =  spline.evaluate ( c, p, rightNeighbourX ) ;
+      } // end for p loop
+
+    if ( ! shared.barrier.wait ( shared.aborted ) )
+      return ;
+    double  largestChange  =  0.0 ;
+    for ( size_t t = 0 ; t < S ; t ++ )
+      largestChange  =  std::max ( largestChange, shared.changes[ parity * S + t ] ) ;
+    converged  =  ( largestChange <= tolerance ) ;
+    iteration ++ ;
+    } // end while
+
+  for ( size_t k = 0 ; k < sd.ownedCount ; k ++ )
+    shared.solution[ sd.ownedFirst + k ]  =  u ( sd.ownedFirst - sd.first + k ) ;
+  if ( s == 0 )
+    {
+    shared.iterations  =  iteration ;
+    shared.converged   =  converged ? 1 : 0 ;
+    } // end if
+  } // end runSubdomain
+
+// ================================================================================================
+
+Eigen::VectorXd  DomainDecomposition::solve ( const Eigen::VectorXd & f, double shift, double diffusivity,
+                                              double tolerance, size_t maxIterations )
+  {
+  assert ( static_cast<size_t>(f.size()) == N ) ;
+  const size_t  S  =  subdomains.size() ;
+  const size_t  q  =  ( order - 1 ) / 2 ;
+
+  // One block holds the SharedState followed by its arrays.
+  size_t  numDoubles  =  ( 2 * S * 2 * q ) + ( 2 * S ) + N ;
+  size_t  headBytes   =  ( (sizeof(SharedState) + sizeof(double) - 1) / sizeof(double) ) * sizeof(double) ;
+  size_t  totalBytes  =  headBytes + numDoubles * sizeof(double) ;
+#ifdef _WIN32
+  std::vector<double>  block ( (totalBytes + sizeof(double) - 1) / sizeof(double) ) ;
+  void *  memory  =  &block[0] ;
+#else
+  void *  memory  =  mmap ( 0, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 ) ;
+  assert ( memory != MAP_FAILED ) ;
+#endif
+  SharedState *  shared  =  new ( memory ) SharedState ;
+  shared->barrier.arrived.store ( 0 ) ;
+  shared->barrier.generation.store ( 0 ) ;
+  shared->barrier.parties  =  S ;
+  shared->aborted.store ( 0 ) ;
+  shared->iterations       =  0 ;
+  shared->converged        =  0 ;
+  shared->interfaceValues  =  reinterpret_cast<double *> ( static_cast<char *>(memory) + headBytes ) ;
+  shared->changes          =  shared->interfaceValues + 2 * S * 2 * q ;
+  shared->solution         =  shared->changes + 2 * S ;
+  for ( size_t k = 0 ; k < numDoubles ; k ++ )
+    shared->interfaceValues[k]  =  0.0 ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    shared->solution[alpha]  =  std::numeric_limits<double>::quiet_NaN() ;
+
+#ifdef _WIN32
+  std::vector<std::thread>  threads ;
+  for ( size_t s = 0 ; s < S ; s ++ )
+    threads.push_back ( std::thread ( &DomainDecomposition::runSubdomain, this, s, std::cref(f),
+                                      shift, diffusivity, tolerance, maxIterations, std::ref(*shared) ) ) ;
+  for ( size_t s = 0 ; s < S ; s ++ )
+    threads[s].join ( ) ;
+#else
+  // Each child inherits f (copy-on-write) and this object, and reports through *shared.
+  std::vector<pid_t>  children ;
+  for ( size_t s = 0 ; s < S ; s ++ )
+    {
+    pid_t  pid  =  fork ( ) ;
+    if ( pid == 0 )
+      {
+      // The child must never return into the caller's code, not even by an exception.
+      try
+        {
+        runSubdomain ( s, f, shift, diffusivity, tolerance, maxIterations, *shared ) ;
+        }
+      catch ( ... )
+        {
+        _exit ( 1 ) ;
+        }
+      _exit ( 0 ) ;  //  skip destructors & stdio buffers belonging to the parent
+      } // end if
+    if ( pid < 0 )
+      {
+      shared->aborted.store ( 1 ) ;
+      break ;
+      } // end if
+    children.push_back ( pid ) ;
+    } // end for s loop
+  // Reap the children in whatever order they finish, polling each by its own pid so that no
+  // other child of the caller is reaped.  If any subdomain dies, the rest must not wait for it
+  // at the barrier:  release them, and kill whichever have not yet finished.
+  while ( ! children.empty() )
+    {
+    bool  reaped  =  false ;
+    for ( size_t c = 0 ; (c < children.size()) && ! reaped ; c ++ )
+      {
+      int    status  =  0 ;
+      pid_t  pid     =  waitpid ( children[c], &status, WNOHANG ) ;
+      if ( (pid == 0) || ((pid < 0) && (errno == EINTR)) )
+        continue ;  //  still running
+      // A child which cannot be waited for (pid < 0) is lost, and counts as failed.
+      bool  succeeded  =  ( pid == children[c] ) && WIFEXITED(status) && ( WEXITSTATUS(status) == 0 ) ;
+      children.erase ( children.begin() + c ) ;
+      reaped  =  true ;
+      if ( ! succeeded && (shared->aborted.exchange ( 1 ) == 0) )
+        for ( size_t k = 0 ; k < children.size() ; k ++ )
+          kill ( children[k], SIGKILL ) ;
+      } // end for c loop
+    if ( ! reaped )
+      std::this_thread::sleep_for ( std::chrono::microseconds ( 200 ) ) ;
+    } // end while
+#endif
+
+  Eigen::VectorXd  u  =  Eigen::Map<Eigen::VectorXd> ( shared->solution, N ) ;
+  lastIterations  =  shared->iterations ;
+  lastConverged   =  ( shared->converged != 0 ) && ( shared->aborted.load() == 0 ) ;
+  shared->~SharedState ( ) ;
+#ifndef _WIN32
+  munmap ( memory, totalBytes ) ;
+#endif
+  return  u ;
+  } // end solve
+
+// ================================================================================================
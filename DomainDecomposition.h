@@ -0,0 +1,131 @@
+/**
+ * @file    DomainDecomposition.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File DomainDecomposition.h contains the declaration of the DomainDecomposition class,
+ * which solves large BSCM boundary value problems on overlapping subdomains.
+ */
+
+#ifndef  DOMAINDECOMPOSITION_H
+#define  DOMAINDECOMPOSITION_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %DomainDecomposition solves&nbsp;
+   * (&nbsp;&sigma; &minus; &kappa;&nbsp;&part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>&nbsp;)&nbsp;<em>u</em> = <em>f</em>
+   * &nbsp;on a lattice too large for one %Spline, by overlapping (additive) Schwarz iteration.
+   *
+   * The <b><em>N</em></b> uniform knot intervals of [&nbsp;<em>xMin</em>, <em>xMax</em>&nbsp;]
+   * are dealt into contiguous blocks, and each block is widened by <em>overlap</em> intervals
+   * on each side to form a subdomain.  Each subdomain has its own %Spline, whose collocation
+   * points coincide with the global ones.  At a physical boundary the subdomain uses the rows of
+   * the global <b><em>K_matrix</em></b>; at an interface, its rows instead fix derivatives
+   * 0, 1, ..., (<b><em>M</em></b>&minus;3)/2 to the values of the neighbouring subdomain's
+   * spline at that point.\n\n
+   * On POSIX systems each subdomain runs in its own process (created by fork), and the
+   * processes exchange interface values through anonymous shared memory, so only a
+   * subdomain's own operator is ever held by any one process.  Elsewhere, each subdomain runs
+   * in its own thread.
+   */
+
+  class  DomainDecomposition
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Divide the lattice into subdomains
+        *
+        * @param order          %Spline order <b><em>M</em></b>
+        * @param xMin           Left physical boundary
+        * @param xMax           Right physical boundary
+        * @param N              Number of uniform knot intervals (and of collocation points)
+        * @param K_matrix       Boundary conditions at the physical boundaries, as for %Spline
+        * @param numSubdomains  Number of subdomains (and of processes)
+        * @param overlap        Number of knot intervals by which each subdomain extends into
+        *                       each neighbour; at least 1, and less than the smallest block
+        */
+      DomainDecomposition ( size_t order, double xMin, double xMax, size_t N,
+                            Eigen::MatrixXi K_matrix, size_t numSubdomains, size_t overlap ) ;
+
+      /**
+        * @brief
+        * Solve&nbsp; (&nbsp;&sigma; &minus; &kappa;&nbsp;<em>O</em><sup>&nbsp;(2)</sup>&nbsp;)&nbsp;<em>u</em> = <em>f</em>
+        *
+        * With &sigma; = 1/<em>dt</em> &amp; &kappa; = diffusivity, this is one implicit
+        * (backward Euler) heat step scaled by 1/<em>dt</em>; with &sigma; = 0 &amp; &kappa; = &minus;1,
+        * it is the Poisson equation <em>u</em>&Prime; = <em>f</em>.
+        * @param f              Right-hand side at the <b><em>N</em></b> global collocation points
+        * @param shift          &sigma;
+        * @param diffusivity    &kappa;
+        * @param tolerance      Iteration stops when no collocation value changes by more than
+        *                       <em>tolerance</em> times the largest value
+        * @param maxIterations  Iteration stops after this many sweeps regardless
+        * @return  Eigen::VectorXd  Solution at the global collocation points
+        */
+      Eigen::VectorXd  solve ( const Eigen::VectorXd & f, double shift, double diffusivity,
+                               double tolerance = 1.0e-12, size_t maxIterations = 1000 ) ;
+
+      /** @brief Global collocation points (midpoints of the knot intervals) */
+      const std::vector<double> &  getCollocationX ( ) const  { return  collocationX ; }
+
+      /** @brief Number of Schwarz iterations taken by the last <b><em>solve</em></b> */
+      size_t  iterations ( ) const  { return  lastIterations ; }
+
+      /** @brief Whether the last <b><em>solve</em></b> met its tolerance */
+      bool  converged ( ) const  { return  lastConverged ; }
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      /**
+        * One subdomain:  knot intervals [ first, first + count ) of the global lattice,
+        * of which it owns (reports the solution on) [ ownedFirst, ownedFirst + ownedCount ).
+        */
+      struct  Subdomain
+        {
+        size_t  first ;
+        size_t  count ;
+        size_t  ownedFirst ;
+        size_t  ownedCount ;
+        } ;
+
+      /**
+        * Layout of the memory shared by the subdomains during <b><em>solve</em></b>.
+        */
+      struct  SharedState ;
+
+      size_t                  order ;
+      double                  xMin ;
+      double                  h ;
+      size_t                  N ;
+      Eigen::MatrixXi         K_matrix ;
+      std::vector<Subdomain>  subdomains ;
+      std::vector<double>     collocationX ;
+      size_t                  lastIterations ;
+      bool                    lastConverged ;
+
+      /**
+        * Build subdomain s's %Spline, then iterate until the shared convergence test passes.
+        */
+      void  runSubdomain ( size_t s, const Eigen::VectorXd & f, double shift, double diffusivity,
+                           double tolerance, size_t maxIterations, SharedState & shared ) const ;
+
+    } ; // end DomainDecomposition class
+
+  } // end namespace BSCM
+
+#endif  //  DOMAINDECOMPOSITION_H
@@ -0,0 +1,297 @@
+/**
+ * @file    FastDiagonalization.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File FastDiagonalization.cpp contains the definition of the FastDiagonalization class,
+ * which solves Poisson &amp; heat problems on tensor-product lattices of BSCM splines.
+ */
+
+#include <cassert>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#include <unsupported/Eigen/MatrixFunctions>
+#include "FastDiagonalization.h"
+
+using namespace BSCM ;
+
+const double  FastDiagonalization::MAX_CONDITION_NUMBER  =  1.0e8 ;
+
+namespace
+  {
+  // Multiply the field (stored with axis 0 fastest) by A along axis `axis`, in place.
+  // Viewed as a column-major matrix of  inner  rows and  N(axis) columns, each of the  outer  slices
+  // is replaced by itself times A transposed; along axis 0 (inner == 1) the slices instead form the
+  // columns of one N(0) by outer matrix, which is multiplied by A.  Blocks of columns, of slices,
+  // or of rows of a slice are dealt to the pool, about four per thread.
+  template < typename Matrix >
+  void  transformAxis ( typename Matrix::Scalar * data, const std::vector<size_t> & dims, size_t axis,
+                        const Matrix & A, ThreadPool & pool )
+    {
+    size_t  inner  =  1, outer  =  1 ;
+    for ( size_t d = 0 ; d < axis ; d ++ )
+      inner  *=  dims[d] ;
+    for ( size_t d = axis + 1 ; d < dims.size() ; d ++ )
+      outer  *=  dims[d] ;
+    const size_t  Nd        =  dims[axis] ;
+    const size_t  numTasks  =  4 * pool.size() ;
+
+    if ( axis == 0 )
+      {
+      size_t  block  =  std::max<size_t> ( 1, (outer + numTasks - 1) / numTasks ) ;
+      for ( size_t c0 = 0 ; c0 < outer ; c0 += block )
+        {
+        size_t  count  =  std::min ( block, outer - c0 ) ;
+        pool.submit ( [=, &A] ( )
+          {
+          Eigen::Map<Matrix>  U ( data + c0 * Nd, Nd, count ) ;
+          Matrix  product  =  A * U ;
+          U  =  product ;
+          } ) ;
+        } // end for c0 loop
+      } // end if
+    else if ( outer >= numTasks )
+      {
+      size_t  block  =  ( outer + numTasks - 1 ) / numTasks ;
+      for ( size_t k0 = 0 ; k0 < outer ; k0 += block )
+        {
+        size_t  count  =  std::min ( block, outer - k0 ) ;
+        pool.submit ( [=, &A] ( )
+          {
+          for ( size_t k = k0 ; k < k0 + count ; k ++ )
+            {
+            Eigen::Map<Matrix>  X ( data + k * inner * Nd, inner, Nd ) ;
+            Matrix  product  =  X * A.transpose() ;
+            X  =  product ;
+            } // end for k loop
+          } ) ;
+        } // end for k0 loop
+      } // end else if
+    else
+      {
+      size_t  pieces  =  ( numTasks + outer - 1 ) / outer ;
+      size_t  block   =  std::max<size_t> ( 1, (inner + pieces - 1) / pieces ) ;
+      for ( size_t k = 0 ; k < outer ; k ++ )
+        for ( size_t r0 = 0 ; r0 < inner ; r0 += block )
+          {
+          size_t  count  =  std::min ( block, inner - r0 ) ;
+          pool.submit ( [=, &A] ( )
+            {
+            Eigen::Map<Matrix>  X ( data + k * inner * Nd, inner, Nd ) ;
+            Matrix  product  =  X.middleRows ( r0, count ) * A.transpose() ;
+            X.middleRows ( r0, count )  =  product ;
+            } ) ;
+          } // end for r0 loop
+      } // end else
+    pool.wait ( ) ;
+    } // end transformAxis
+  } // end anonymous namespace
+
+// ================================================================================================
+
+// constructor
+FastDiagonalization::FastDiagonalization ( const std::vector<SplinePtr> & splines, size_t numThreads )
+  : axes ( splines.size() ), numPoints ( 1 ), diagonalized ( true ), realSpectrum ( true ),
+    pool ( numThreads )
+  {
+  assert ( ! splines.empty() ) ;
+  for ( size_t d = 0 ; d < splines.size() ; d ++ )
+    {
+    Axis &  axis  =  axes[d] ;
+    numPoints  *=  splines[d]->getN() ;
+    size_t  e  =  std::find ( splines.begin(), splines.end(), splines[d] ) - splines.begin() ;
+    if ( e < d )
+      {
+      axis  =  axes[e] ;  //  same Spline, same eigenvectors
+      continue ;
+      } // end if
+
+    axis.N  =  splines[d]->getN() ;
+    axis.D  =  splines[d]->cachedOperatorMatrix ( 2 ) ;
+    Eigen::EigenSolver<Eigen::MatrixXd>  solver ( axis.D ) ;
+    assert ( solver.info() == Eigen::Success ) ;
+    axis.lambda  =  solver.eigenvalues() ;
+    axis.V       =  solver.eigenvectors() ;
+
+    // A defective (or nearly defective) operator shows up as an ill-conditioned V.
+    Eigen::JacobiSVD<Eigen::MatrixXcd>  svd ( axis.V ) ;
+    const Eigen::VectorXd &  sigma  =  svd.singularValues() ;
+    axis.condition  =  ( sigma(axis.N-1) > 0.0 ) ? ( sigma(0) / sigma(axis.N-1) )
+                                                 : ( std::numeric_limits<double>::infinity() ) ;
+    axis.diagonalized  =  ( axis.condition <= MAX_CONDITION_NUMBER ) ;
+    if ( ! axis.diagonalized )
+      {
+      // Fallback:  the Schur form  D = U T U^H,  with U unitary and T upper triangular, whose
+      // diagonal holds the eigenvalues in the order the modes of this axis then take.
+      Eigen::ComplexSchur<Eigen::MatrixXd>  schur ( axis.D ) ;
+      assert ( schur.info() == Eigen::Success ) ;
+      axis.V          =  schur.matrixU ( ) ;
+      axis.V_inverse  =  axis.V.adjoint ( ) ;
+      axis.T          =  schur.matrixT ( ) ;
+      axis.lambda     =  axis.T.diagonal ( ) ;
+      axis.real       =  false ;
+      diagonalized    =  false ;
+      continue ;
+      } // end if
+    axis.V_inverse  =  axis.V.partialPivLu().inverse() ;
+
+    // Real eigenvalues come with real eigenvectors.
+    axis.real  =  ( axis.lambda.imag().array() == 0.0 ).all() ;
+    if ( axis.real )
+      {
+      axis.realV          =  axis.V.real() ;
+      axis.realV_inverse  =  axis.realV.partialPivLu().inverse() ;
+      } // end if
+    } // end for d loop
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    realSpectrum  =  realSpectrum && axes[d].real ;
+  } // end constructor
+
+// ================================================================================================
+
+Eigen::VectorXcd  FastDiagonalization::eigenvalueSums ( bool diagonalizedOnly ) const
+  {
+  Eigen::VectorXcd  sums  =  Eigen::VectorXcd::Zero ( numPoints ) ;
+  size_t  stride  =  1 ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    {
+    if ( axes[d].diagonalized || ! diagonalizedOnly )
+      for ( size_t idx = 0 ; idx < numPoints ; idx ++ )
+        sums ( idx )  +=  axes[d].lambda ( (idx / stride) % axes[d].N ) ;
+    stride  *=  axes[d].N ;
+    } // end for d loop
+  return  sums ;
+  } // end eigenvalueSums
+
+// ================================================================================================
+
+Eigen::VectorXd  FastDiagonalization::scaleModes ( const Eigen::VectorXd & u, const Eigen::VectorXcd & weights,
+                                                   const ModeOperation & operation ) const
+  {
+  assert ( static_cast<size_t>(u.size()) == numPoints ) ;
+  std::vector<size_t>  dims ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    dims.push_back ( axes[d].N ) ;
+
+  if ( realSpectrum )
+    {
+    Eigen::VectorXd  field  =  u ;
+    for ( size_t d = 0 ; d < axes.size() ; d ++ )
+      transformAxis ( field.data(), dims, d, axes[d].realV_inverse, pool ) ;
+    field.array()  *=  weights.real().array() ;
+    for ( size_t d = 0 ; d < axes.size() ; d ++ )
+      transformAxis ( field.data(), dims, d, axes[d].realV, pool ) ;
+    return  field ;
+    } // end if
+
+  // With an axis in its Schur basis, the modes are coupled along that axis, and
+  // operation (rather than the weights alone) carries them over.
+  Eigen::VectorXcd  field  =  u.cast< std::complex<double> >() ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    transformAxis ( field.data(), dims, d, axes[d].V_inverse, pool ) ;
+  field.array()  *=  weights.array() ;
+  if ( operation )
+    operation ( field, dims ) ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    transformAxis ( field.data(), dims, d, axes[d].V, pool ) ;
+  return  field.real() ;
+  } // end scaleModes
+
+// ================================================================================================
+
+Eigen::VectorXd  FastDiagonalization::solve ( const Eigen::VectorXd & rho, double scale, double shift ) const
+  {
+  Eigen::VectorXcd  shifted  =  ( scale * eigenvalueSums() ).array() + shift ;
+
+  // An eigenvalue can be found only to about (condition number) * epsilon * (largest eigenvalue).
+  // (A Schur basis is unitary, so an axis in its Schur basis adds nothing to the condition.)
+  double  condition  =  1.0 ;
+  size_t  maxN       =  1 ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    {
+    if ( axes[d].diagonalized )
+      condition  =  std::max ( condition, axes[d].condition ) ;
+    maxN       =  std::max ( maxN, axes[d].N ) ;
+    } // end for d loop
+  double  tolerance  =  shifted.cwiseAbs().maxCoeff() * maxN * condition * std::numeric_limits<double>::epsilon() ;
+
+  Eigen::VectorXcd  weights ( numPoints ) ;
+  for ( size_t idx = 0 ; idx < numPoints ; idx ++ )
+    weights ( idx )  =  ( std::abs(shifted(idx)) > tolerance ) ? ( 1.0 / shifted(idx) ) : ( 0.0 ) ;
+  if ( diagonalized )
+    return  scaleModes ( rho, weights ) ;
+
+  // Fallback:  in the mixed basis, a times the sum of the axis operators (diagonal, or upper
+  // triangular T), plus the shift, is upper triangular in the order of the lattice index, so it
+  // is solved by back substitution from the last point to the first, in
+  // O( (number of points) (sum of N over the Schur axes) ) operations.
+  Eigen::VectorXcd  ones  =  Eigen::VectorXcd::Ones ( numPoints ) ;
+  return  scaleModes ( rho, ones, [&] ( Eigen::VectorXcd & field, const std::vector<size_t> & dims )
+    {
+    for ( size_t idx = numPoints ; idx -- > 0 ; )
+      {
+      std::complex<double>  value  =  field ( idx ) ;
+      size_t  stride  =  1 ;
+      for ( size_t d = 0 ; d < dims.size() ; d ++ )
+        {
+        if ( ! axes[d].diagonalized )
+          {
+          size_t  i  =  ( idx / stride ) % dims[d] ;
+          for ( size_t k = i + 1 ; k < dims[d] ; k ++ )
+            value  -=  scale * axes[d].T ( i, k ) * field ( idx + (k - i) * stride ) ;
+          } // end if
+        stride  *=  dims[d] ;
+        } // end for d loop
+      field ( idx )  =  value * weights ( idx ) ;
+      } // end for idx loop
+    } ) ;
+  } // end solve
+
+// ================================================================================================
+
+Eigen::VectorXd  FastDiagonalization::propagate ( const Eigen::VectorXd & u0, double t, double diffusivity ) const
+  {
+  // The axis operators commute, so the exponential of their sum is the product of their
+  // exponentials:  a weight for each mode of the diagonalized axes, and exp(kappa t T) along
+  // each axis in its Schur basis.
+  Eigen::VectorXcd  weights  =  ( (diffusivity * t) * eigenvalueSums ( true ) ).array().exp() ;
+  if ( diagonalized )
+    return  scaleModes ( u0, weights ) ;
+  return  scaleModes ( u0, weights, [&] ( Eigen::VectorXcd & field, const std::vector<size_t> & dims )
+    {
+    for ( size_t d = 0 ; d < axes.size() ; d ++ )
+      if ( ! axes[d].diagonalized )
+        {
+        Eigen::MatrixXcd  E  =  ( (diffusivity * t) * axes[d].T ).exp() ;
+        transformAxis ( field.data(), dims, d, E, pool ) ;
+        } // end if
+    } ) ;
+  } // end propagate
+
+// ================================================================================================
+
+Eigen::VectorXd  FastDiagonalization::apply ( const Eigen::VectorXd & u, double scale, double shift ) const
+  {
+  assert ( static_cast<size_t>(u.size()) == numPoints ) ;
+  std::vector<size_t>  dims ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    dims.push_back ( axes[d].N ) ;
+
+  Eigen::VectorXd  result  =  shift * u ;
+  for ( size_t d = 0 ; d < axes.size() ; d ++ )
+    {
+    Eigen::VectorXd  term  =  u ;
+    transformAxis ( term.data(), dims, d, axes[d].D, pool ) ;
+    result  +=  scale * term ;
+    } // end for d loop
+  return  result ;
+  } // end apply
+
+// ================================================================================================
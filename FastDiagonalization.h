@@ -0,0 +1,200 @@
+/**
+ * @file    FastDiagonalization.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File FastDiagonalization.h contains the declaration of the FastDiagonalization class,
+ * which solves Poisson &amp; heat problems on tensor-product lattices of BSCM splines.
+ */
+
+#ifndef  FASTDIAGONALIZATION_H
+#define  FASTDIAGONALIZATION_H
+
+#include <vector>
+#include <functional>
+#include <Eigen/Dense>
+#include "Spline.h"
+#include "ThreadPool.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %FastDiagonalization solves&nbsp;
+   * (&nbsp;<em>a</em>&nbsp;&Delta; + &sigma;&nbsp;)&nbsp;<em>u</em> = &rho; &nbsp;and evaluates&nbsp;
+   * <em>u</em>(<em>t</em>) = exp(&nbsp;&kappa;&nbsp;<em>t</em>&nbsp;&Delta;&nbsp;)&nbsp;<em>u</em>(0)
+   * &nbsp;on the lattice of collocation points of a box, one %Spline per axis.
+   *
+   * The collocation Laplacian is the sum over axes <em>d</em> of
+   * <em>O<sub>d</sub></em> = operatorMatrix(2) of axis <em>d</em>, acting on that axis alone.
+   * Each <em>O<sub>d</sub></em> is diagonalized once,
+   * <em>O<sub>d</sub></em> = <em>V<sub>d</sub></em>&nbsp;&Lambda;<sub><em>d</em></sub>&nbsp;<em>V<sub>d</sub></em><sup>&minus;1</sup>,
+   * so that &Delta; is diagonalized by the tensor product of the <em>V<sub>d</sub></em>, with
+   * eigenvalues &lambda;<sub>0,<em>i</em></sub> + &lambda;<sub>1,<em>j</em></sub> + ... .
+   * A solve transforms the field by each <em>V<sub>d</sub></em><sup>&minus;1</sup> in turn, scales
+   * each mode, and transforms back by each <em>V<sub>d</sub></em>, in
+   * O(<b><em>N</em></b><sup>&nbsp;<em>D</em>+1</sup>) operations on a lattice of
+   * <b><em>N</em></b><sup>&nbsp;<em>D</em></sup> points, against
+   * O(<b><em>N</em></b><sup>&nbsp;3<em>D</em></sup>) for factoring the dense operator.\n\n
+   * A field is stored with the index of axis 0 varying fastest:&nbsp; point
+   * (<em>i</em><sub>0</sub>,&nbsp;<em>i</em><sub>1</sub>,&nbsp;<em>i</em><sub>2</sub>) is entry
+   * <em>i</em><sub>0</sub> + <em>N</em><sub>0</sub>&nbsp;(&nbsp;<em>i</em><sub>1</sub> +
+   * <em>N</em><sub>1</sub>&nbsp;<em>i</em><sub>2</sub>&nbsp;).  The transform along an axis is
+   * then a matrix product with each slice of the field, and the slices (or blocks of rows of
+   * them) are dealt to the threads of a ThreadPool.\n
+   * The collocation operators are not symmetric, so their eigenvalues may be complex; when
+   * every axis has a real spectrum, the transforms are made in real arithmetic.
+   * As for SpectralPropagator, an eigenvector basis too ill-conditioned to use leaves
+   * <b><em>isDiagonalized</em></b> false, and that axis falls back on its Schur form
+   * <em>O<sub>d</sub></em> = <em>U<sub>d</sub></em>&nbsp;<em>T<sub>d</sub></em>&nbsp;<em>U<sub>d</sub></em><sup>H</sup>,
+   * with <em>T<sub>d</sub></em> upper triangular:&nbsp; <b><em>solve</em></b> then back-substitutes
+   * along that axis (serially, in O(<b><em>N</em></b><sup>&nbsp;<em>D</em>+1</sup>) operations for each such
+   * axis), and <b><em>propagate</em></b> applies exp(&nbsp;&kappa;&nbsp;<em>t</em>&nbsp;<em>T<sub>d</sub></em>&nbsp;)
+   * along it.  The Schur vectors are unitary, so the fallback costs speed rather than accuracy.
+   */
+
+  class  FastDiagonalization
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Diagonalize operatorMatrix(2) of each axis
+        *
+        * An axis sharing its %Spline with an earlier axis shares its eigenvectors too.
+        * @param splines     One %Spline per axis, typically two or three
+        * @param numThreads  Number of threads for the transforms; 0 selects one per hardware thread
+        */
+      explicit FastDiagonalization ( const std::vector<SplinePtr> & splines, size_t numThreads = 0 ) ;
+
+      /**
+        * @brief
+        * false when some axis's eigenvector basis was too ill-conditioned to use, and that
+        * axis uses its Schur form instead
+        */
+      bool  isDiagonalized ( ) const  { return  diagonalized ; }
+
+      /**
+        * @brief
+        * Condition number of the eigenvector matrix of axis <em>axis</em>
+        */
+      double  conditionNumber ( size_t axis ) const  { return  axes[axis].condition ; }
+
+      /**
+        * @brief
+        * Number of axes
+        */
+      size_t  numAxes ( ) const  { return  axes.size() ; }
+
+      /**
+        * @brief
+        * Number of collocation points along axis <em>axis</em>
+        */
+      size_t  getN ( size_t axis ) const  { return  axes[axis].N ; }
+
+      /**
+        * @brief
+        * Number of lattice points, the product of <b><em>getN</em></b> over the axes
+        */
+      size_t  size ( ) const  { return  numPoints ; }
+
+      /**
+        * @brief
+        * Solution <em>u</em> of&nbsp; (&nbsp;<em>a</em>&nbsp;&Delta; + &sigma;&nbsp;)&nbsp;<em>u</em> = &rho;
+        *
+        * A mode whose eigenvalue vanishes (the constant, under Neumann or periodic conditions
+        * and &sigma; = 0) is left out of <em>u</em>, as by Spline::solvePeriodic.
+        * @param rho    &rho; at the lattice points
+        * @param scale  <em>a</em>
+        * @param shift  &sigma;
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  solve ( const Eigen::VectorXd & rho, double scale = 1.0, double shift = 0.0 ) const ;
+
+      /**
+        * @brief
+        * Lattice values at time <em>t</em> of the heat equation, starting from <em>u0</em> at time 0
+        *
+        * Exact in time:&nbsp; each mode is multiplied by the exponential of
+        * &kappa;&nbsp;<em>t</em> times its eigenvalue, so any <em>t</em> costs the same.
+        * @param u0           Initial lattice values
+        * @param t            Time
+        * @param diffusivity  Thermal diffusivity &kappa;
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  propagate ( const Eigen::VectorXd & u0, double t, double diffusivity ) const ;
+
+      /**
+        * @brief
+        * (&nbsp;<em>a</em>&nbsp;&Delta; + &sigma;&nbsp;)&nbsp;<em>u</em>, from the operators themselves
+        *
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  apply ( const Eigen::VectorXd & u, double scale = 1.0, double shift = 0.0 ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      FastDiagonalization ( const FastDiagonalization & ) ;              // not copyable
+      FastDiagonalization &  operator= ( const FastDiagonalization & ) ; // not assignable
+
+      /**
+        * Eigenvector bases with a larger condition number are not used.
+        */
+      static const double  MAX_CONDITION_NUMBER ;
+
+      /**
+        * One axis:&nbsp; its operator, eigenvalues &amp; eigenvectors, the latter also in real
+        * arithmetic when the spectrum is real.
+        */
+      struct  Axis
+        {
+        size_t            N ;
+        Eigen::MatrixXd   D ;
+        Eigen::VectorXcd  lambda ;
+        Eigen::MatrixXcd  V ;
+        Eigen::MatrixXcd  V_inverse ;
+        Eigen::MatrixXd   realV ;
+        Eigen::MatrixXd   realV_inverse ;
+        Eigen::MatrixXcd  T ;             //  triangular Schur factor, when not diagonalized
+        bool              diagonalized ;  //  V holds eigenvectors; otherwise Schur vectors
+        bool              real ;
+        double            condition ;
+        } ;
+
+      std::vector<Axis>   axes ;
+      size_t              numPoints ;
+      bool                diagonalized ;
+      bool                realSpectrum ;  //  every axis has a real spectrum
+      mutable ThreadPool  pool ;
+
+      /**
+        * Eigenvalue of the Laplacian for each lattice point's mode (summed over the
+        * diagonalized axes alone, if <em>diagonalizedOnly</em>).
+        */
+      Eigen::VectorXcd  eigenvalueSums ( bool diagonalizedOnly = false ) const ;
+
+      /**
+        * Work on the transformed field, given the size of each axis.
+        */
+      typedef  std::function< void ( Eigen::VectorXcd &, const std::vector<size_t> & ) >  ModeOperation ;
+
+      /**
+        * <em>u</em> &larr; <em>V</em>&nbsp;diag(<em>weights</em>)&nbsp;<em>V</em><sup>&minus;1</sup>&nbsp;<em>u</em>,
+        * with <em>V</em> the tensor product of the eigenvectors (or Schur vectors), and
+        * <em>operation</em>, if any, applied after the weights.
+        */
+      Eigen::VectorXd  scaleModes ( const Eigen::VectorXd & u, const Eigen::VectorXcd & weights,
+                                    const ModeOperation & operation = ModeOperation() ) const ;
+
+    } ; // end FastDiagonalization class
+
+  } // end namespace BSCM
+
+#endif  //  FASTDIAGONALIZATION_H
@@ -0,0 +1,163 @@
+/**
+ * @file    KrylovPropagator.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File KrylovPropagator.cpp contains the definition of the KrylovPropagator class,
+ * which applies the exponential of a collocation operator to a vector.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <unsupported/Eigen/MatrixFunctions>
+#include "KrylovPropagator.h"
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor
+KrylovPropagator::KrylovPropagator ( Operator A, double tolerance, size_t krylovDimension )
+  : A ( A ), tolerance ( tolerance ), krylovDimension ( krylovDimension ),
+    lastApplications ( 0 ), lastSubsteps ( 0 )
+  {
+  assert ( A && (tolerance > 0.0) && (krylovDimension >= 2) ) ;
+  } // end constructor
+
+// ================================================================================================
+
+KrylovPropagator  KrylovPropagator::heat ( SplinePtr spline, double diffusivity,
+                                           double tolerance, size_t krylovDimension )
+  {
+  assert ( spline ) ;
+  return  KrylovPropagator ( [spline, diffusivity] ( const Eigen::VectorXd & u )
+                               { return  Eigen::VectorXd ( diffusivity * spline->applyOperator ( 2, u ) ) ; },
+                             tolerance, krylovDimension ) ;
+  } // end heat
+
+// ================================================================================================
+
+Eigen::VectorXd  KrylovPropagator::apply ( const Eigen::VectorXd & u, double t )
+  {
+  assert ( t >= 0.0 ) ;
+  lastApplications  =  0 ;
+  lastSubsteps      =  0 ;
+
+  const size_t  n      =  u.size() ;
+  const size_t  m      =  std::min ( krylovDimension, n ) ;
+  const double  uNorm  =  u.norm() ;
+  Eigen::VectorXd  w  =  u ;
+  if ( (t == 0.0) || (uNorm == 0.0) )
+    return  w ;
+
+  // Error allowed per unit time, so that the substeps' errors sum to at most tolerance * |u|.
+  const double  errorRate  =  tolerance * uNorm / t ;
+  const double  GAMMA      =  0.9 ;  //  safety factor on each new step size
+  const double  DELTA      =  1.2 ;  //  slack on the local error test
+
+  Eigen::MatrixXd  V ( n, m + 1 ) ;
+  Eigen::MatrixXd  H ( m + 2, m + 2 ) ;
+  Eigen::MatrixXd  F ;
+  double  tNow  =  0.0 ;
+  double  tau   =  -1.0 ;  //  chosen after the first Arnoldi process
+  while ( tNow < t )
+    {
+    double  beta  =  w.norm() ;
+    if ( beta == 0.0 )
+      break ;
+
+    // Arnoldi process (modified Gram-Schmidt):  A V(:,0..k-1) = V H(0..k,0..k-1).
+    V.col(0)  =  w / beta ;
+    H.setZero ( ) ;
+    size_t  k          =  m ;
+    bool    breakdown  =  false ;
+    for ( size_t j = 0 ; j < m ; j ++ )
+      {
+      Eigen::VectorXd  p  =  A ( V.col(j) ) ;
+      lastApplications ++ ;
+      double  pNorm  =  p.norm() ;
+      for ( size_t i = 0 ; i <= j ; i ++ )
+        {
+        H ( i, j )  =  V.col(i).dot ( p ) ;
+        p  -=  H ( i, j ) * V.col(i) ;
+        } // end for i loop
+      double  s  =  p.norm() ;
+      if ( s <= tolerance * pNorm )
+        {
+        // "Happy breakdown":  the subspace is invariant, so its exponential is exact.
+        breakdown  =  true ;
+        k          =  j + 1 ;
+        break ;
+        } // end if
+      H ( j+1, j )  =  s ;
+      V.col(j+1)    =  p / s ;
+      } // end for j loop
+
+    // Augmenting H (Saad's corrected scheme) yields the error estimate in F itself.
+    double  avNorm  =  0.0 ;
+    if ( ! breakdown )
+      {
+      H ( m+1, m )  =  1.0 ;
+      avNorm  =  A ( V.col(m) ).norm() ;
+      lastApplications ++ ;
+      } // end if
+
+    if ( tau < 0.0 )
+      {
+      // Sidje's first step, from an estimate of |A|.
+      double  aNorm  =  H.topLeftCorner(k,k).cwiseAbs().rowwise().sum().maxCoeff() ;
+      double  fact   =  std::pow ( (m + 1) / std::exp(1.0), static_cast<double>(m + 1) )
+                      * std::sqrt ( 8.0 * std::atan(1.0) * (m + 1) ) ;
+      tau  =  ( aNorm > 0.0 ) ? ( std::pow ( fact * tolerance / (4.0 * aNorm), 1.0 / m ) / aNorm ) : t ;
+      } // end if
+    if ( breakdown || (tau > t - tNow) )
+      tau  =  t - tNow ;
+
+    // Shrink tau until the local error estimate passes; the basis stays valid throughout.
+    size_t  size   =  breakdown ? k : ( m + 2 ) ;
+    double  error  =  0.0 ;
+    double  xm     =  1.0 / m ;
+    while ( true )
+      {
+      lastSubsteps ++ ;
+      F  =  ( tau * H.topLeftCorner ( size, size ) ).exp() ;
+      if ( breakdown )
+        break ;
+      double  phi1  =  std::abs ( beta * F ( m, 0 ) ) ;
+      double  phi2  =  std::abs ( beta * F ( m+1, 0 ) * avNorm ) ;
+      if ( phi1 > 10.0 * phi2 )
+        error  =  phi2 ;
+      else if ( phi1 > phi2 )
+        error  =  ( phi1 * phi2 ) / ( phi1 - phi2 ) ;
+      else
+        {
+        error  =  phi1 ;
+        xm     =  1.0 / std::max<size_t> ( m - 1, 1 ) ;
+        } // end else
+      if ( error <= DELTA * tau * errorRate )
+        break ;
+      tau  =  std::isfinite ( error ) ? ( GAMMA * tau * std::pow ( tau * errorRate / error, xm ) )
+                                      : ( 0.1 * tau ) ;
+      assert ( tau > 0.0 ) ;
+      } // end while
+
+    size_t  used  =  breakdown ? k : ( m + 1 ) ;
+    w  =  V.leftCols ( used ) * ( beta * F.col(0).head ( used ) ) ;
+    tNow  =  ( tau >= t - tNow ) ? t : ( tNow + tau ) ;
+
+    // Next step size, from this step's error.
+    if ( ! breakdown )
+      tau  =  GAMMA * tau * std::pow ( tau * errorRate / std::max ( error, std::numeric_limits<double>::min() ), xm ) ;
+    } // end while
+
+  return  w ;
+  } // end apply
+
+// ================================================================================================
@@ -0,0 +1,109 @@
+/**
+ * @file    KrylovPropagator.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File KrylovPropagator.h contains the declaration of the KrylovPropagator class,
+ * which applies the exponential of a collocation operator to a vector.
+ */
+
+#ifndef  KRYLOVPROPAGATOR_H
+#define  KRYLOVPROPAGATOR_H
+
+#include <functional>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %KrylovPropagator computes&nbsp; exp(&nbsp;<em>t</em>&nbsp;<em>A</em>&nbsp;)&nbsp;<em>u</em>
+   * &nbsp;using only products of <em>A</em> with vectors.
+   *
+   * The interval [&nbsp;0, <em>t</em>&nbsp;] is crossed in substeps.  In each substep, an Arnoldi
+   * process builds an orthonormal basis of the Krylov subspace
+   * span{&nbsp;<em>w</em>, <em>A</em>&nbsp;<em>w</em>, ..., <em>A</em><sup><em>m</em>&minus;1</sup>&nbsp;<em>w</em>&nbsp;}
+   * together with the small Hessenberg matrix <em>H</em> representing <em>A</em> on it,
+   * and exp(&nbsp;&tau;&nbsp;<em>A</em>&nbsp;)&nbsp;<em>w</em> is approximated by the exponential
+   * of &tau;&nbsp;<em>H</em>, of dimension only <em>m</em>.  The local error is estimated from
+   * the next term of the expansion; a substep whose error is too large is retried with a smaller
+   * &tau;, using the same basis, and the next &tau; is chosen from the error of the last
+   * (Sidje's <em>expv</em>, ACM TOMS 24, 1998).\n\n
+   * No <b><em>N</em></b> by <b><em>N</em></b> matrix is ever formed:  storage is
+   * <b><em>N</em></b>&nbsp;(<em>m</em>+1) numbers, and the cost is that of the products with
+   * <em>A</em> plus O(<b><em>N</em></b>&nbsp;<em>m</em><sup>2</sup>) per substep.
+   */
+
+  class  KrylovPropagator
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * The operator <em>A</em>, as a function returning <em>A</em>&nbsp;<em>u</em>
+        */
+      typedef  std::function< Eigen::VectorXd ( const Eigen::VectorXd & ) >  Operator ;
+
+      /**
+        * @brief
+        * Construct a propagator for the operator <em>A</em>
+        *
+        * @param A                Function returning <em>A</em>&nbsp;<em>u</em>
+        * @param tolerance        Error allowed in exp(<em>t</em>&nbsp;<em>A</em>)&nbsp;<em>u</em>,
+        *                         relative to the norm of <em>u</em>
+        * @param krylovDimension  Dimension <em>m</em> of each Krylov subspace
+        */
+      KrylovPropagator ( Operator A, double tolerance = 1.0e-10, size_t krylovDimension = 30 ) ;
+
+      /**
+        * @brief
+        * The heat-equation propagator&nbsp; exp(&nbsp;&kappa;&nbsp;<em>t</em>&nbsp;<em>O</em><sup>&nbsp;(2)</sup>&nbsp;)
+        *
+        * <em>A</em> = &kappa;&nbsp;<em>O</em><sup>&nbsp;(2)</sup> is applied by
+        * <em>spline</em>-&gt;applyOperator(2,&nbsp;<em>u</em>).
+        * @param spline           %Spline supplying <em>O</em><sup>&nbsp;(2)</sup>
+        * @param diffusivity      Thermal diffusivity &kappa;
+        * @param tolerance        As for the constructor
+        * @param krylovDimension  As for the constructor
+        * @return  KrylovPropagator
+        */
+      static KrylovPropagator  heat ( SplinePtr spline, double diffusivity,
+                                      double tolerance = 1.0e-10, size_t krylovDimension = 30 ) ;
+
+      /**
+        * @brief
+        * exp(&nbsp;<em>t</em>&nbsp;<em>A</em>&nbsp;)&nbsp;<em>u</em>
+        *
+        * @param u  Vector (of collocation values) at time 0
+        * @param t  Time; must not be negative
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  apply ( const Eigen::VectorXd & u, double t ) ;
+
+      /** @brief Number of products with <em>A</em> made by the last <b><em>apply</em></b> */
+      size_t  operatorApplications ( ) const  { return  lastApplications ; }
+
+      /** @brief Number of substeps (accepted &amp; rejected) taken by the last <b><em>apply</em></b> */
+      size_t  substeps ( ) const  { return  lastSubsteps ; }
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      Operator  A ;
+      double    tolerance ;
+      size_t    krylovDimension ;
+      size_t    lastApplications ;
+      size_t    lastSubsteps ;
+
+    } ; // end KrylovPropagator class
+
+  } // end namespace BSCM
+
+#endif  //  KRYLOVPROPAGATOR_H
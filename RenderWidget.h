@@ -9,6 +9,8 @@
 #include <QWidget>
 #include <QPainter>
 #include <QPen>
+#include <QPointF>
+#include <QElapsedTimer>
 #include <vector>
 #include <cmath>
 
@@ -16,8 +18,6 @@
 
 #include "Spline.h"
 #include <Eigen/Dense>
-#include <Eigen/LU>
-#include <unsupported/Eigen/MatrixFunctions>
 
 class RenderWidget : public QWidget
   {
@@ -30,11 +30,11 @@ class RenderWidget : public QWidget
   public:  //  ====================  constructor  ====================
     double f ( double x )
       {
-        return  ( 100.0 * sin( 4.0 * atan(1.0) * x / 800.0 ) ) ;
+        return  ( 100.0 * sin( pi * x / 800.0 ) ) ;
       } // end f
 
     RenderWidget ( int argc, char **argv, QWidget *parent = 0 )
-        : QWidget (parent)
+        : QWidget (parent), pi ( 4.0 * atan(1.0) ), averageFrameMs ( 0.0 )
       {
       order_M       =   3 ;
       num_Coll_Pts  =   3 ;
@@ -69,6 +69,8 @@ class RenderWidget : public QWidget
   protected :
     void paintEvent ( QPaintEvent * pep )
       {
+      QElapsedTimer  frameTimer ;
+      frameTimer.start ( ) ;
       //{ // ---------------------------------------------------------------------------------
       const unsigned int         SPLINE_ORDER  =  3 ;
       const double               KNOT_ARRAY []  =  { 100, 200, 300, 400, 500, 600, 700, 800 } ;
@@ -92,14 +94,18 @@ class RenderWidget : public QWidget
         x  +=  delta_x ;
         }
       knotX.push_back ( right_Knot ) ;
-      // instantiate the Spline class ...
-      BSCM::Spline  test_Spline ( order_M, knotX, constraintMatrix ) ;
-      Eigen::MatrixXd  opMtrx  =  test_Spline.operatorMatrix(2) ;
-      Eigen::MatrixXd  E_to_the_D  =  opMtrx.exp() ;
+      // instantiate the Spline class, unless only the end knots have moved:  uniform knots
+      // then move by an affine map, and the existing Spline's operators are merely rescaled ...
+      if ( ! test_Spline_Ptr || (test_Spline_Ptr->getOrder() != order_M)
+                             || (test_Spline_Ptr->getN() != num_Coll_Pts) )
+        test_Spline_Ptr  =  BSCM::Spline::create ( order_M, knotX, constraintMatrix ) ;
+      else if ( knotX != test_Spline_Ptr->getKnotX() )
+        test_Spline_Ptr  =  test_Spline_Ptr->withKnots ( knotX ) ;
+      const BSCM::Spline &  test_Spline  =  *test_Spline_Ptr ;
       Eigen::Vector3d  f_alpha ;
-      f_alpha <<  f(test_Spline.collocationX[0]),
-                  f(test_Spline.collocationX[1]),
-                  f(test_Spline.collocationX[2]) ;
+      f_alpha <<  f(test_Spline.getCollocationX()[0]),
+                  f(test_Spline.getCollocationX()[1]),
+                  f(test_Spline.getCollocationX()[2]) ;
 
 
 /*
@@ -109,6 +115,27 @@ class RenderWidget : public QWidget
           f←  A ∙f   (new f obtained by multiplying preceding f by A)
 */
 
+      // Fill the vertex arrays first, then hand each to Qt in a single call.
+      // The arrays are members, so once they have grown they are reused without allocating.
+      double  axisY  =  this->height() / 2 ;
+      knotPoints.clear ( ) ;
+      for
+        (
+          std::vector<double>::iterator it = knotX.begin() ;
+          it != knotX.end() ;
+          ++it
+        )
+          knotPoints.push_back ( QPointF ( *it, axisY ) ) ;
+      profilePoints.clear ( ) ;
+      for ( int x = 0 ; x <= 800 ; x ++ )
+        profilePoints.push_back ( QPointF ( x, axisY + floor(f(x)) ) ) ;
+      collocationPoints.clear ( ) ;
+      for ( size_t alpha = 0 ; alpha < test_Spline.getCollocationX().size() ; alpha ++ )
+        {
+        double x = test_Spline.getCollocationX()[alpha] ;
+        collocationPoints.push_back ( QPointF ( x, axisY + floor(f(x)) ) ) ;
+        }
+
       QPainter  painter ( this ) ;
       QPen  blackPen ( QColor(0,0,0)) ;
       QPen  redPen ( QColor(255,0,0)) ;
@@ -118,34 +145,29 @@ class RenderWidget : public QWidget
       painter.setPen(blackPen);
       painter.drawLine(0,this->height()/2,this->width(),this->height()/2);
       painter.setPen(redPen);
-      for
-        (
-          std::vector<double>::iterator it = knotX.begin() ;
-          it != knotX.end() ;
-          ++it
-        )
-          {
-          double  x  =  *it ;
-          painter.drawPoint ( x, this->height()/2 ) ;
-          }// end for loop
-
-      for ( int x = 0 ; x <= 800 ; x ++ )
-        painter.drawPoint( x, (this->height()/2) + floor(f(x)) );
+      painter.drawPoints ( knotPoints.data(), knotPoints.size() ) ;
+      redPen.setJoinStyle ( Qt::RoundJoin ) ;  //  a wide polyline, rounded like the wide points it replaces
+      painter.setPen(redPen);
+      painter.drawPolyline ( profilePoints.data(), profilePoints.size() ) ;
       painter.setPen(bluePen);
-      for ( int alpha = 0 ; alpha < test_Spline.collocationX.size() ; alpha ++ )
-        {
-        double x = test_Spline.collocationX[alpha] ;
-        double y = f(x) ;
-        painter.drawPoint( x, (this->height()/2) + floor(y) );
-        }
+      painter.drawPoints ( collocationPoints.data(), collocationPoints.size() ) ;
+
+      // frame-time counter:  this frame, and a running average over recent frames
+      double  frameMs  =  frameTimer.nsecsElapsed() / 1.0e6 ;
+      averageFrameMs   =  ( averageFrameMs == 0.0 ) ? frameMs : ( 0.9 * averageFrameMs + 0.1 * frameMs ) ;
+      painter.setPen(blackPen);
+      painter.drawText ( 10, 20, QString("frame %1 ms  (average %2 ms)")
+                                   .arg ( frameMs, 0, 'f', 2 ).arg ( averageFrameMs, 0, 'f', 2 ) ) ;
 
 /*
+      // applies e^[D] to a vector without forming it  (needs #include "KrylovPropagator.h")
+      BSCM::KrylovPropagator  E_to_the_D  =  BSCM::KrylovPropagator::heat ( test_Spline_Ptr, 1.0 ) ;
       for ( int t = 0 ; t < 3 ; t ++ )
         {
-        f_alpha  =  E_to_the_D * f_alpha ;
-        for ( int alpha = 0 ; alpha < test_Spline.collocationX.size() ; alpha ++ )
+        f_alpha  =  E_to_the_D.apply ( f_alpha, 1.0 ) ;
+        for ( int alpha = 0 ; alpha < test_Spline.getCollocationX().size() ; alpha ++ )
           {
-          double x = test_Spline.collocationX[alpha] ;
+          double x = test_Spline.getCollocationX()[alpha] ;
           double y = f(x) ;
           painter.drawPoint( floor(x), floor(y) );
           }
@@ -242,6 +264,13 @@ double        right_Knot ;
     double        left_Knot ;
     double        right_Knot ;
 
+    const double           pi ;
+    double                 averageFrameMs ;     //  exponential moving average of the paint time
+    std::vector<QPointF>   knotPoints ;         //  vertex arrays, refilled each frame
+    std::vector<QPointF>   profilePoints ;
+    std::vector<QPointF>   collocationPoints ;
+    BSCM::SplinePtr        test_Spline_Ptr ;    //  kept between frames; see paintEvent
+
   }; // end RenderWidget class
 
 #endif // RENDERWIDGET_H
@@ -0,0 +1,173 @@
+/**
+ * @file    SpectralPropagator.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File SpectralPropagator.cpp contains the definition of the SpectralPropagator class,
+ * which evaluates the BSCM solution of the heat equation at arbitrary times.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#include <unsupported/Eigen/MatrixFunctions>
+#include "SpectralPropagator.h"
+
+using namespace BSCM ;
+
+const double  SpectralPropagator::MAX_CONDITION_NUMBER  =  1.0e8 ;
+
+namespace
+  {
+  // Order eigenvalues by decreasing real part (most slowly decaying first), and a
+  // complex-conjugate pair by decreasing imaginary part, so that the pair is adjacent.
+  struct  SlowestFirst
+    {
+    const Eigen::VectorXcd &  lambda ;
+    explicit SlowestFirst ( const Eigen::VectorXcd & lambda ) : lambda ( lambda ) { }
+    bool  operator() ( size_t a, size_t b ) const
+      {
+      if ( lambda(a).real() != lambda(b).real() )
+        return  lambda(a).real() > lambda(b).real() ;
+      return  lambda(a).imag() > lambda(b).imag() ;
+      }
+    } ; // end SlowestFirst struct
+  } // end anonymous namespace
+
+// ================================================================================================
+
+// constructor
+SpectralPropagator::SpectralPropagator ( const Spline & spline )
+  : N ( spline.getN() )
+  {
+  Eigen::MatrixXd  D  =  spline.operatorMatrix ( 2 ) ;
+  Eigen::EigenSolver<Eigen::MatrixXd>  solver ( D ) ;
+  assert ( solver.info() == Eigen::Success ) ;
+
+  std::vector<size_t>  order ( N ) ;
+  for ( size_t m = 0 ; m < N ; m ++ )
+    order[m]  =  m ;
+  std::sort ( order.begin(), order.end(), SlowestFirst ( solver.eigenvalues() ) ) ;
+
+  lambda.resize ( N ) ;
+  V.resize ( N, N ) ;
+  for ( size_t m = 0 ; m < N ; m ++ )
+    {
+    lambda(m)  =  solver.eigenvalues() ( order[m] ) ;
+    V.col(m)   =  solver.eigenvectors().col ( order[m] ) ;
+    } // end for m loop
+
+  // A defective (or nearly defective) operator shows up as an ill-conditioned V.
+  Eigen::JacobiSVD<Eigen::MatrixXcd>  svd ( V ) ;
+  const Eigen::VectorXd &  sigma  =  svd.singularValues() ;
+  eigenvectorCondition  =  ( sigma(N-1) > 0.0 ) ? ( sigma(0) / sigma(N-1) )
+                                                 : ( std::numeric_limits<double>::infinity() ) ;
+  diagonalized  =  ( eigenvectorCondition <= MAX_CONDITION_NUMBER ) ;
+  if ( diagonalized )
+    V_inverse  =  V.partialPivLu().inverse() ;
+  else
+    {
+    Eigen::RealSchur<Eigen::MatrixXd>  schur ( D ) ;
+    assert ( schur.info() == Eigen::Success ) ;
+    schurU  =  schur.matrixU() ;
+    schurT  =  schur.matrixT() ;
+    } // end else
+  } // end constructor
+
+// ================================================================================================
+
+Eigen::VectorXcd  SpectralPropagator::modalCoefficients ( const Eigen::VectorXd & u0 ) const
+  {
+  assert ( diagonalized ) ;
+  assert ( static_cast<size_t>(u0.size()) == N ) ;
+  return  V_inverse * u0.cast< std::complex<double> >() ;
+  } // end modalCoefficients
+
+// ================================================================================================
+
+size_t  SpectralPropagator::modesKept ( size_t numModes ) const
+  {
+  if ( (numModes == 0) || (numModes >= N) )
+    return  N ;
+  // Keeping one member of a conjugate pair would drop half of the pair's real contribution.
+  if ( (lambda(numModes-1).imag() != 0.0) && (lambda(numModes) == std::conj(lambda(numModes-1))) )
+    return  numModes + 1 ;
+  return  numModes ;
+  } // end modesKept
+
+// ================================================================================================
+
+Eigen::MatrixXd  SpectralPropagator::evaluateModes ( const Eigen::VectorXcd & coefficients,
+                                                     const std::vector<double> & times,
+                                                     double diffusivity, size_t numModes ) const
+  {
+  assert ( diagonalized ) ;
+  assert ( static_cast<size_t>(coefficients.size()) == N ) ;
+  size_t  k  =  modesKept ( numModes ) ;
+
+  // Column j of the weights holds  exp(kappa t_j lambda_m) c_m  for the modes kept.
+  Eigen::MatrixXcd  weights ( k, times.size() ) ;
+  for ( size_t j = 0 ; j < times.size() ; j ++ )
+    for ( size_t m = 0 ; m < k ; m ++ )
+      weights ( m, j )  =  std::exp ( (diffusivity * times[j]) * lambda(m) ) * coefficients(m) ;
+
+  return  ( V.leftCols(k) * weights ).real() ;
+  } // end evaluateModes
+
+// ================================================================================================
+
+Eigen::MatrixXd  SpectralPropagator::evaluate ( const Eigen::VectorXd & u0, const std::vector<double> & times,
+                                                double diffusivity, size_t numModes ) const
+  {
+  assert ( static_cast<size_t>(u0.size()) == N ) ;
+  if ( diagonalized )
+    return  evaluateModes ( modalCoefficients ( u0 ), times, diffusivity, numModes ) ;
+
+  // Fallback:  exp(kappa t D) u0 = U exp(kappa t T) U^T u0, from the Schur form found once;
+  // every mode is kept, whatever numModes.  The times are visited in increasing order, each
+  // reached from the one before by  exp(kappa (t_j - t_(j-1)) T),  and that exponential is
+  // reused for as long as the step stays the same, so evenly spaced times cost one exponential.
+  std::vector<size_t>  order ( times.size() ) ;
+  for ( size_t j = 0 ; j < times.size() ; j ++ )
+    order[j]  =  j ;
+  std::sort ( order.begin(), order.end(), [&] ( size_t a, size_t b ) { return  times[a] < times[b] ; } ) ;
+
+  Eigen::VectorXd  w  =  schurU.transpose() * u0 ;
+  Eigen::MatrixXd  weights ( N, times.size() ) ;
+  Eigen::MatrixXd  stepExponential ;
+  double           previous  =  0.0, step  =  0.0 ;
+  for ( size_t j = 0 ; j < times.size() ; j ++ )
+    {
+    double  gap  =  times[order[j]] - previous ;
+    if ( gap != 0.0 )
+      {
+      if ( (stepExponential.size() == 0) || (std::abs(gap - step) > 1.0e-12 * std::abs(gap)) )
+        {
+        step             =  gap ;
+        stepExponential  =  ( (diffusivity * step) * schurT ).exp() ;
+        } // end if
+      w  =  stepExponential * w ;
+      } // end if
+    weights.col ( order[j] )  =  w ;
+    previous  =  times[order[j]] ;
+    } // end for j loop
+  return  schurU * weights ;
+  } // end evaluate
+
+// ================================================================================================
+
+Eigen::VectorXd  SpectralPropagator::evaluate ( const Eigen::VectorXd & u0, double t, double diffusivity,
+                                                size_t numModes ) const
+  {
+  return  evaluate ( u0, std::vector<double> ( 1, t ), diffusivity, numModes ).col ( 0 ) ;
+  } // end evaluate
+
+// ================================================================================================
@@ -0,0 +1,157 @@
+/**
+ * @file    SpectralPropagator.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File SpectralPropagator.h contains the declaration of the SpectralPropagator class,
+ * which evaluates the BSCM solution of the heat equation at arbitrary times.
+ */
+
+#ifndef  SPECTRALPROPAGATOR_H
+#define  SPECTRALPROPAGATOR_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %SpectralPropagator evaluates&nbsp;
+   * <em>u</em>(<em>t</em>) = exp(&nbsp;&kappa;&nbsp;<em>t</em>&nbsp;<em>O</em><sup>&nbsp;(2)</sup>&nbsp;)&nbsp;<em>u</em>(0)
+   * &nbsp;for any time <em>t</em> and diffusivity &kappa;.
+   *
+   * The operator <em>O</em><sup>&nbsp;(2)</sup> = operatorMatrix(2) is diagonalized once,
+   * <em>O</em><sup>&nbsp;(2)</sup> = <em>V</em>&nbsp;&Lambda;&nbsp;<em>V</em><sup>&minus;1</sup>,
+   * after which <em>u</em>(<em>t</em>) = <em>V</em>&nbsp;exp(&kappa;&nbsp;<em>t</em>&nbsp;&Lambda;)&nbsp;<em>c</em>,
+   * with modal coefficients <em>c</em> = <em>V</em><sup>&minus;1</sup>&nbsp;<em>u</em>(0).\n
+   * Computing <em>c</em> costs O(<em>N</em><sup>2</sup>); thereafter each time costs
+   * O(<em>N</em>&nbsp;<em>k</em>) when only the <em>k</em> most slowly decaying modes are kept.\n\n
+   * The collocation operator is not symmetric, so <em>V</em> may be ill-conditioned
+   * (or the operator defective).  In that case the eigenvector basis is not used; the
+   * constructor instead computes the real Schur form
+   * <em>O</em><sup>&nbsp;(2)</sup> = <em>U</em>&nbsp;<em>T</em>&nbsp;<em>U</em><sup>&nbsp;T</sup>,
+   * and each time is evaluated as
+   * <em>U</em>&nbsp;exp(&kappa;&nbsp;<em>t</em>&nbsp;<em>T</em>)&nbsp;<em>U</em><sup>&nbsp;T</sup>&nbsp;<em>u</em>(0),
+   * visiting the times in increasing order and stepping between them; one exponential of the
+   * quasi-triangular <em>T</em> serves every step of the same length, so evenly spaced times
+   * cost one exponential and a matrix-vector product each.
+   * Without an eigenbasis there are no separate modes to drop, so this fallback ignores
+   * <em>numModes</em> and always keeps all of them.
+   */
+
+  class  SpectralPropagator
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Diagonalize operatorMatrix(2) of <em>spline</em>
+        */
+      explicit SpectralPropagator ( const Spline & spline ) ;
+
+      /**
+        * @brief
+        * false when the eigenvector basis was too ill-conditioned to use
+        */
+      bool  isDiagonalized ( ) const  { return  diagonalized ; }
+
+      /**
+        * @brief
+        * Condition number of the eigenvector matrix <em>V</em>
+        */
+      double  conditionNumber ( ) const  { return  eigenvectorCondition ; }
+
+      /**
+        * @brief
+        * Eigenvalues of operatorMatrix(2), most slowly decaying (largest real part) first
+        */
+      const Eigen::VectorXcd &  eigenvalues ( ) const  { return  lambda ; }
+
+      /**
+        * @brief
+        * Modal coefficients <em>c</em> = <em>V</em><sup>&minus;1</sup>&nbsp;<em>u0</em>,
+        * in the order of <b><em>eigenvalues</em></b>
+        */
+      Eigen::VectorXcd  modalCoefficients ( const Eigen::VectorXd & u0 ) const ;
+
+      /**
+        * @brief
+        * Collocation values at time <em>t</em>, starting from <em>u0</em> at time 0
+        *
+        * @param u0           Initial collocation values
+        * @param t            Time
+        * @param diffusivity  Thermal diffusivity &kappa;
+        * @param numModes     Number of modes kept; 0 keeps all of them.  Ignored (all kept)
+        *                     unless <b><em>isDiagonalized</em></b>.
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  evaluate ( const Eigen::VectorXd & u0, double t, double diffusivity,
+                                  size_t numModes = 0 ) const ;
+
+      /**
+        * @brief
+        * Collocation values at each of several times, as the columns of a matrix
+        *
+        * All times are evaluated by one matrix product.
+        * @param u0           Initial collocation values
+        * @param times        Times
+        * @param diffusivity  Thermal diffusivity &kappa;
+        * @param numModes     Number of modes kept; 0 keeps all of them.  Ignored (all kept)
+        *                     unless <b><em>isDiagonalized</em></b>.
+        * @return  Eigen::MatrixXd  of dimensions <b><em>N</em></b> by times.size()
+        */
+      Eigen::MatrixXd  evaluate ( const Eigen::VectorXd & u0, const std::vector<double> & times,
+                                  double diffusivity, size_t numModes = 0 ) const ;
+
+      /**
+        * @brief
+        * Collocation values at each of several times, from precomputed modal coefficients
+        *
+        * Costs O(<em>N</em>&nbsp;<em>k</em>) per time for <em>k</em> modes kept.
+        * Requires <b><em>isDiagonalized</em></b>.
+        * @param coefficients  Result of <b><em>modalCoefficients</em></b>
+        * @param times         Times
+        * @param diffusivity   Thermal diffusivity &kappa;
+        * @param numModes      Number of modes kept; 0 keeps all of them
+        * @return  Eigen::MatrixXd  of dimensions <b><em>N</em></b> by times.size()
+        */
+      Eigen::MatrixXd  evaluateModes ( const Eigen::VectorXcd & coefficients,
+                                       const std::vector<double> & times,
+                                       double diffusivity, size_t numModes = 0 ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      /**
+        * Eigenvector bases with a larger condition number are not used.
+        */
+      static const double  MAX_CONDITION_NUMBER ;
+
+      size_t            N ;
+      Eigen::MatrixXd   schurU ;  //  real Schur form of operatorMatrix(2), computed only for the
+      Eigen::MatrixXd   schurT ;  //  matrix-exponential fallback
+      Eigen::VectorXcd  lambda ;
+      Eigen::MatrixXcd  V ;
+      Eigen::MatrixXcd  V_inverse ;
+      bool              diagonalized ;
+      double            eigenvectorCondition ;
+
+      /**
+        * Number of modes actually used when <em>numModes</em> are requested: all of them for 0,
+        * and one more when the last requested mode would split a complex-conjugate pair.
+        */
+      size_t  modesKept ( size_t numModes ) const ;
+
+    } ; // end SpectralPropagator class
+
+  } // end namespace BSCM
+
+#endif  //  SPECTRALPROPAGATOR_H
@@ -14,6 +14,8 @@
 
 #include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <unsupported/Eigen/FFT>
 #include "Spline.h"
 
 using namespace BSCM ;
@@ -21,11 +23,13 @@ using namespace BSCM ;
 // ================================================================================================
 
 // constructor
-Spline::Spline ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix )
+Spline::Spline ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix,
+                 const CollocationStrategy & strategy )
+  : collocationStrategy ( strategy )
   {
   assert ( (order % 2) == 1 ) ;
   assert ( (MIN_ORDER <= order) && (order <= MAX_ORDER) ) ;
-  assert ( ((2 * order) <= knotX.size()) && (knotX.size() <= MAX_NUMBER_KNOTS) ) ;
+  assert ( (2 * order) <= knotX.size() ) ;
 
   // Save parameters' values as instance variables.
   this->order     =  order ;
@@ -34,98 +38,462 @@ Spline::Spline ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matr
   this->K_matrix  =  K_matrix ;
   this->xMin      =  knotX [ order - 1 ] ;
   this->xMax      =  knotX [ numKnots - order ] ;
+  this->periodic  =  false ;
 
-  // Determine collocation points within physical boundaries.
-  // Also, confirm that, *within physical boundaries*, each knot is strictly less than its successor.
+  // Confirm that, *within physical boundaries*, each knot is strictly less than its successor.
   for ( int i = (order - 1) ; i < (numKnots - order) ; i ++ )
-    {
     assert ( knotX[i] < knotX[i+1] ) ;
-    collocationX.push_back ( (knotX[i] + knotX[i+1]) / 2 ) ;
-    } // end for i loop
+
+  // Determine collocation points within physical boundaries, and the knot interval of each.
+  collocationX  =  collocationStrategy.points ( order, knotX ) ;
   assert ( collocationX.size() == (numKnots - (2 * order) + 1) ) ; // # of knots = N + 2M - 1
+  assert ( CollocationStrategy::schoenbergWhitney ( order, knotX, collocationX ) ) ;
   this->N  =  collocationX.size() ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    collocationInterval.push_back ( std::max ( std::min ( knotInterval ( collocationX[alpha] ),
+                                                          numKnots - order - 1 ), order - 1 ) ) ;
+
+  // Only the piecewise-polynomial table is needed by the banded operations; the dense tables
+  // of B(k,i,alpha) & B_matrix wait until they are asked for.
+  tabulatePiecewisePolynomials ( ) ;
+  operatorCache  =  std::make_shared<OperatorCache> ( ) ;
+  basisTables    =  std::make_shared<BasisTables> ( ) ;
+
+  assembleBoundaryConditions ( ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// constructor sharing knots & basis tables of another Spline
+Spline::Spline ( const Spline & basis, Eigen::MatrixXi K_matrix )
+  : order ( basis.order ), knotX ( basis.knotX ), numKnots ( basis.numKnots ),
+    collocationX ( basis.collocationX ), collocationStrategy ( basis.collocationStrategy ),
+    collocationInterval ( basis.collocationInterval ), N ( basis.N ), basisTables ( basis.basisTables ),
+    K_matrix ( K_matrix ), periodic ( false ),
+    xMin ( basis.xMin ), xMax ( basis.xMax ), ppCoefficients ( basis.ppCoefficients )
+  {
+  assert ( ! basis.periodic ) ;
+  assembleBoundaryConditions ( ) ;
+  operatorCache  =  std::make_shared<OperatorCache> ( ) ;
+  inheritOperators ( basis ) ;
+  } // end constructor
 
-  // Prepare vector that is to store values of B(k,i,alpha).
-  B_k_i_alpha  =  std::vector< std::vector< std::vector<double> > >
-    ( order + 1, // index k = 0 will not be used; values of k = 1 .. M will be used
-      std::vector< std::vector<double> >(0) // initially empty vectors for all indices k
-     ) ;
-  // Values in B_k_i_alpha all initially Not-a-Number (NaN), but those values
-  // are replaced as they are calculated.
-  for ( size_t k = 1 ; k <= order ; k ++ )
-    B_k_i_alpha.at(k)
-      =  std::vector< std::vector<double> >
-         ( N + 2*order - k - 1, std::vector<double>(N,std::numeric_limits<double>::quiet_NaN()) ) ;
-
-  // Assign values of B(M,i,alpha) to B_matrix.
-  B_matrix  =  Eigen::MatrixXd::Zero ( N, (N + order - 1) ) ;
-  for ( size_t alpha = 0 ; alpha < static_cast<size_t>(B_matrix.rows()) ; alpha ++ )
-    for ( size_t i = 0 ; i < static_cast<size_t>(B_matrix.cols()) ; i ++ )
-      B_matrix(alpha,i)  =  B ( order, i, alpha ) ;
+// ================================================================================================
+
+void  Spline::inheritOperators ( const Spline & basis )
+  // Sherman-Morrison-Woodbury:  with E selecting the beta rows of B_tilde and D = beta - basis.beta,
+  //   B_tilde = basis.B_tilde + E D ,  so
+  //   C_tilde = basis.C_tilde - (basis.C_tilde E) (I + D basis.C_tilde E)^-1 (D basis.C_tilde) .
+  // Because basis.beta * basis.C_tilde = [ 0  I ], the middle factor reduces to  beta Z  with
+  // Z = basis.C_tilde E, and the last factor (restricted to the collocation columns) to
+  // R = beta basis.C_tilde(:, collocation columns).  Then, for each derivative order p,
+  //   O = basis.O - (D_p Z) (beta Z)^-1 R ,  where D_p Z is basis.liftingMatrix(p).
+  {
+  bool  anyCached  =  false ;
+  for ( size_t p = 0 ; p < order ; p ++ )
+    anyCached  =  anyCached || basis.operatorCache->ready[p] ;
+  if ( ! anyCached )
+    return ;
+
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  const size_t  n  =  N + order - 1 ;
+
+  // Z:  coefficients of basis's lifting functions, as in liftingMatrix.
+  Eigen::MatrixXd  Z  =  Eigen::MatrixXd::Zero ( n, (order - 1) ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    {
+    Z ( r,         r     )  =  1.0 ;
+    Z ( q + N + r, q + r )  =  1.0 ;
+    } // end for r loop
+  basis.solveCoefficients ( Z ) ;
+
+  // R transposed:  basis.C_tilde^T beta^T, by solving with the transpose of basis.B_tilde,
+  // whose rows (and so C_tilde's columns) are ordered [ left beta; collocation; right beta ].
+  Eigen::MatrixXd  Y  =  beta_matrix.transpose ( ) ;
+  basis.B_tilde_factors.solveTransposeInPlace ( Y ) ;
+  Eigen::MatrixXd  R  =  Y.middleRows ( q, N ).transpose ( ) ;
 
+  Eigen::MatrixXd  correction  =  ( beta_matrix * Z ).partialPivLu().solve ( R ) ;
+  for ( size_t p = 0 ; p < order ; p ++ )
+    if ( basis.operatorCache->ready[p] )
+      {
+      Eigen::MatrixXd  lifting ( N, (order - 1) ) ;
+      differentiateCoefficients ( p, Z, lifting ) ;
+      OperatorCache &  cache  =  *operatorCache ;
+      std::call_once ( cache.once[p], [&] ( )
+        {
+        cache.matrix[p]  =  basis.operatorCache->matrix[p] ;
+        cache.matrix[p].noalias()  -=  lifting * correction ;
+        cache.ready[p]  =  true ;
+        } ) ;
+      } // end if
+  } // end inheritOperators
+
+// ================================================================================================
+
+void  Spline::assembleBoundaryConditions ( )
+  // Build beta_matrix & B_tilde_factors from K_matrix & the basis tables.
+  {
   // Assign values within beta_matrix according to Umar's Equation (18), p. 432.
+  // Only the M basis functions nonzero on the boundary's knot interval contribute.
   beta_matrix  =  Eigen::MatrixXd::Zero ( (order - 1), (order + N - 1) ) ;
   for ( int r = 0 ; r < beta_matrix.rows() ; r ++ )
     {
     // First half of rows are evaluated at left boundary; second half at right boundary.
     // xMin would be left boundary of physical region; use xMax for right boundary.
     double  x  =  ( (r < (order / 2)) ? (xMin) : (xMax) ) ;
-    for ( int i = 0 ; i < beta_matrix.cols() ; i ++ )
+    size_t  j  =  knotInterval ( x ) ;
+    for ( size_t l = 0 ; l < order ; l ++ )
       {
+      size_t  i  =  j + 1 + l - order ;
+      if ( (j + 1 + l < order) || (i >= static_cast<size_t>(beta_matrix.cols())) )
+        continue ;
       double  sum  =  0.0 ;
       for ( size_t p = 0 ; p < order ; p ++ )
-        sum  +=  ( K_matrix(r,p) * D_B ( p, order, i, x ) ) ;
+        if ( K_matrix(r,p) != 0 )
+          sum  +=  ( K_matrix(r,p) * ppDerivative ( p, j, l, x - knotX[j] ) ) ;
       beta_matrix ( r, i )  =  sum ;
-      } // end for i loop
+      } // end for l loop
     } // end for r loop
 
-  // Create & assign B_tilde_matrix of Umar's Equation (20), p. 433.
-  B_tilde_matrix  =  Eigen::MatrixXd::Zero ( (N + order - 1), (N + order - 1) ) ;
-  B_tilde_matrix << B_matrix, beta_matrix ;
+  // Factor "B tilde" of Umar's Equation (20), p. 433, in place of forming its inverse,
+  // "C tilde" of Umar's Equation (22).  With the left rows of beta first and the right
+  // rows last, every nonzero lies within (M-1) places of the main diagonal.
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  B_tilde_factors  =  BandedLU<double> ( N + order - 1, order - 1, order - 1 ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      B_tilde_factors.coeffRef ( r, l )  =  beta_matrix ( r, l ) ;
+      if ( l + 1 < order )
+        B_tilde_factors.coeffRef ( q + N + r, N + l )  =  beta_matrix ( q + r, N + l ) ;
+      } // end for l loop
+  // Schoenberg-Whitney keeps firstBasis(alpha) within q places of alpha, and so within the band.
+  // The M nonzero elements of row alpha of B_matrix come from the piecewise-polynomial table.
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  j  =  collocationInterval [ alpha ] ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      B_tilde_factors.coeffRef ( q + alpha, firstBasis(alpha) + l )  =  ppDerivative ( 0, j, l, collocationX[alpha] - knotX[j] ) ;
+    } // end for alpha loop
+  bool  invertible  =  B_tilde_factors.factorize ( ) ;
+  assert ( invertible ) ;
+  (void) invertible ;
+  } // end assembleBoundaryConditions
+
+// ================================================================================================
+
+void  Spline::solveCoefficients ( Eigen::Ref<Eigen::MatrixXd> rhs ) const
+  // Apply "C tilde" by solving with the banded factors of "B tilde".
+  {
+  B_tilde_factors.solveInPlace ( rhs ) ;
+  } // end solveCoefficients
+
+// ================================================================================================
+
+void  Spline::tabulatePiecewisePolynomials ( )
+  // Convert the basis of order M to piecewise-polynomial form, one knot interval at a time.
+  {
+  ppCoefficients.assign ( (numKnots - 1) * order * order, 0.0 ) ;
+
+  // poly[l][d]:  coefficient of t^d (t = x - knotX[j]) in the l'th basis function of the
+  // current order k nonzero on interval j, namely B(k, j-k+1+l).
+  std::vector< std::vector<double> >  poly ( order, std::vector<double>(order) ) ;
+  std::vector< std::vector<double> >  next ( order, std::vector<double>(order) ) ;
+  for ( size_t j = 0 ; j + 1 < numKnots ; j ++ )
+    {
+    if ( knotX[j] == knotX[j+1] )  //  an empty interval, on which every B(k,i) is zero
+      continue ;
+    poly[0].assign ( order, 0.0 ) ;
+    poly[0][0]  =  1.0 ;  //  Umar's Equation (2):  B(1,j) = 1 on interval j
+    for ( size_t k = 2 ; k <= order ; k ++ )
+      {
+      // Umar's Equation (1), with (x - x_i) = t + (x_j - x_i) and (x_(i+k) - x) = (x_(i+k) - x_j) - t.
+      // B(k-1,i) is poly[l-1] (when l >= 1); B(k-1,i+1) is poly[l] (when l <= k-2).
+      for ( size_t l = 0 ; l < k ; l ++ )
+        {
+        next[l].assign ( order, 0.0 ) ;
+        long  i  =  static_cast<long>(j + l) - static_cast<long>(k - 1) ;
+        if ( (i < 0) || (static_cast<size_t>(i) + k >= numKnots) )
+          continue ;
+        double  left   =  knotX[i+k-1] - knotX[i] ;
+        double  right  =  knotX[i+k]   - knotX[i+1] ;
+        if ( (l >= 1) && (left > 0.0) )
+          for ( size_t d = 0 ; d + 1 < k ; d ++ )
+            {
+            next[l][d]    +=  poly[l-1][d] * ( knotX[j] - knotX[i] ) / left ;
+            next[l][d+1]  +=  poly[l-1][d] / left ;
+            } // end for d loop
+        if ( (l + 2 <= k) && (right > 0.0) )
+          for ( size_t d = 0 ; d + 1 < k ; d ++ )
+            {
+            next[l][d]    +=  poly[l][d] * ( knotX[i+k] - knotX[j] ) / right ;
+            next[l][d+1]  -=  poly[l][d] / right ;
+            } // end for d loop
+        } // end for l loop
+      poly.swap ( next ) ;
+      } // end for k loop
+
+    for ( size_t l = 0 ; l < order ; l ++ )
+      for ( size_t d = 0 ; d < order ; d ++ )
+        ppCoefficients[ (j * order + l) * order + d ]  =  poly[l][d] ;
+    } // end for j loop
+  } // end tabulatePiecewisePolynomials
+
+// ================================================================================================
+
+size_t  Spline::knotInterval ( double x ) const
+  // Find j with knotX[j] <= x < knotX[j+1]; empty intervals are never returned.
+  {
+  size_t  j  =  std::upper_bound ( knotX.begin(), knotX.end(), x ) - knotX.begin() ;
+  return  std::min ( j, numKnots - 1 ) - 1 ;
+  } // end knotInterval
+
+// ================================================================================================
+
+double  Spline::ppDerivative ( size_t p, size_t j, size_t l, double t ) const
+  // Horner's scheme for  sum over d >= p  of  a_d * d!/(d-p)! * t^(d-p).
+  {
+  assert ( p < order ) ;
+  const double *  a  =  &ppCoefficients[ (j * order + l) * order ] ;
+  double  factor  =  1.0 ;  //  (M-1)! / (M-1-p)!
+  for ( size_t d = order - p ; d < order ; d ++ )
+    factor  *=  d ;
+  double  sum  =  0.0 ;
+  for ( size_t d = order - 1 ; d + 1 > p ; d -- )
+    {
+    sum  =  sum * t + a[d] * factor ;
+    if ( d > p )
+      factor  =  factor * ( d - p ) / d ;  //  d!/(d-p)!  to  (d-1)!/(d-1-p)!
+    } // end for d loop
+  return  sum ;
+  } // end ppDerivative
+
+// ================================================================================================
+
+// periodic constructor
+Spline::Spline ( size_t order, double xMin, double xMax, size_t N )
+  : collocationStrategy ( CollocationStrategy::midpoint ( ) )
+  {
+  assert ( (order % 2) == 1 ) ;
+  assert ( (MIN_ORDER <= order) && (order <= MAX_ORDER) ) ;
+  assert ( (order <= N) && (xMin < xMax) ) ;
+
+  this->order     =  order ;
+  this->N         =  N ;
+  this->numKnots  =  N + 2*order - 1 ;
+  this->xMin      =  xMin ;
+  this->xMax      =  xMax ;
+  this->periodic  =  true ;
+
+  // Uniform knots, with (order - 1) knots beyond each physical boundary,
+  // so that knotX [ order - 1 ] == xMin and knotX [ numKnots - order ] == xMax.
+  double  h  =  ( xMax - xMin ) / N ;
+  for ( size_t j = 0 ; j < numKnots ; j ++ )
+    knotX.push_back ( xMin + ( static_cast<double>(j) - static_cast<double>(order - 1) ) * h ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    collocationX.push_back ( xMin + ( alpha + 0.5 ) * h ) ;
+    collocationInterval.push_back ( order - 1 + alpha ) ;
+    } // end for alpha loop
+
+  // Basis function i (of the extended knot sequence) is identified with periodic basis
+  // function (i mod N).  Row alpha of the periodic B matrix (or of its p'th derivative)
+  // is row 0 shifted right by alpha places, so each is circulant:  C(alpha,beta) = c[beta-alpha].
+  // The eigenvalue of mode exp(2 pi i k alpha / N) is then  sum_m c[m] exp(2 pi i k m / N).
+  const double  TWO_PI  =  8.0 * atan(1.0) ;
+  std::vector<Eigen::VectorXcd>  basisSymbol ( order, Eigen::VectorXcd::Zero(N) ) ;
+  for ( size_t p = 0 ; p < order ; p ++ )
+    for ( size_t m = 0 ; m < order ; m ++ )  //  B(order,m) is nonzero at collocationX[0]
+      {
+      double  c_m  =  D_B ( p, order, m, collocationX[0] ) ;
+      for ( size_t k = 0 ; k < N ; k ++ )
+        basisSymbol[p](k)  +=  c_m * std::polar ( 1.0, TWO_PI * ((k * m) % N) / N ) ;
+      } // end for m loop
+
+  // O = D B^-1 , so the symbol of O is the quotient of symbols.
+  // Midpoint collocation of odd-order splines keeps every symbol of B nonzero.
+  for ( size_t p = 0 ; p < order ; p ++ )
+    operatorSymbol.push_back ( basisSymbol[p].cwiseQuotient ( basisSymbol[0] ) ) ;
+  operatorCache  =  std::make_shared<OperatorCache> ( ) ;
+  basisTables    =  std::make_shared<BasisTables> ( ) ;
+  } // end periodic constructor
+
+// ================================================================================================
+
+SplinePtr  Spline::create ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix,
+                           const CollocationStrategy & strategy )
+  {
+  return  std::make_shared<const Spline> ( order, knotX, K_matrix, strategy ) ;
+  } // end create
 
-  // Create & assign C_tilde_matrix of Umar's Equation (22), p. 433.
-  // Note: one could also consider using Eigen::FullPivLU
-  //       if one wants to confirm that B_tilde_matrix is invertible.
-  Eigen::PartialPivLU<Eigen::MatrixXd>  thePartialPivLU ( B_tilde_matrix ) ;
-  C_tilde_matrix  =  thePartialPivLU.inverse() ;
+// ================================================================================================
+
+SplinePtr  Spline::create ( const Spline & basis, Eigen::MatrixXi K_matrix )
+  {
+  return  std::make_shared<const Spline> ( basis, K_matrix ) ;
+  } // end create (sharing basis)
+
+// ================================================================================================
+
+SplinePtr  Spline::updateBoundaryConditions ( Eigen::MatrixXi K_matrix ) const
+  {
+  return  std::make_shared<const Spline> ( *this, K_matrix ) ;
+  } // end updateBoundaryConditions
+
+// ================================================================================================
+
+// constructor for the affine image of another Spline
+Spline::Spline ( const Spline & basis, double shift, double scale )
+  : order ( basis.order ), knotX ( basis.knotX ), numKnots ( basis.numKnots ),
+    collocationX ( basis.collocationX ), collocationStrategy ( basis.collocationStrategy ),
+    collocationInterval ( basis.collocationInterval ), N ( basis.N ), basisTables ( basis.basisTables ),
+    K_matrix ( basis.K_matrix ), periodic ( basis.periodic ),
+    xMin ( shift + scale * basis.xMin ), xMax ( shift + scale * basis.xMax ),
+    ppCoefficients ( basis.ppCoefficients ),
+    operatorSymbol ( basis.operatorSymbol ),
+    operatorCache ( std::make_shared<OperatorCache> ( ) )
+  {
+  assert ( scale > 0.0 ) ;
+  for ( size_t j = 0 ; j < numKnots ; j ++ )
+    knotX[j]  =  shift + scale * knotX[j] ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    collocationX[alpha]  =  shift + scale * collocationX[alpha] ;
+
+  // d/dx' = (1/scale) d/dx:  the p'th derivative of everything is multiplied by scale^-p.
+  for ( size_t k = 0 ; k < ppCoefficients.size() ; k ++ )
+    ppCoefficients[k]  *=  std::pow ( scale, - static_cast<double>(k % order) ) ;
+  for ( size_t p = 0 ; p < operatorSymbol.size() ; p ++ )
+    operatorSymbol[p]  *=  std::pow ( scale, - static_cast<double>(p) ) ;
+  if ( ! periodic )
+    assembleBoundaryConditions ( ) ;
+
+  // Each beta_matrix row involving a single derivative order is merely multiplied by a constant,
+  // which leaves the operators (with zero boundary values) unchanged but for their own scale^-p.
+  bool  rowsScale  =  true ;
+  for ( long r = 0 ; r < K_matrix.rows() ; r ++ )
+    rowsScale  =  rowsScale && ( (K_matrix.row(r).array() != 0).count() <= 1 ) ;
+  if ( ! rowsScale )
+    return ;
+  for ( size_t p = 0 ; p < order ; p ++ )
+    if ( basis.operatorCache->ready[p] )
+      {
+      OperatorCache &  cache  =  *operatorCache ;
+      std::call_once ( cache.once[p], [&] ( )
+        {
+        cache.matrix[p]  =  std::pow ( scale, - static_cast<double>(p) ) * basis.operatorCache->matrix[p] ;
+        cache.ready[p]  =  true ;
+        } ) ;
+      } // end if
   } // end constructor
 
 // ================================================================================================
 
-double Spline::B ( size_t k, size_t i, size_t alpha )
+SplinePtr  Spline::mapAffinely ( double shift, double scale ) const
+  {
+  // The constructor is private, so std::make_shared cannot reach it.
+  return  SplinePtr ( new Spline ( *this, shift, scale ) ) ;
+  } // end mapAffinely
+
+// ================================================================================================
+
+SplinePtr  Spline::withKnots ( const std::vector<double> & knotX ) const
+  {
+  assert ( ! periodic ) ;
+  if ( knotX.size() == numKnots )
+    {
+    double  scale  =  ( knotX.back() - knotX.front() ) / ( this->knotX.back() - this->knotX.front() ) ;
+    double  shift  =  knotX.front() - scale * this->knotX.front() ;
+    double  slack  =  1.0e-12 * std::abs ( knotX.back() - knotX.front() ) ;
+    bool    affine  =  ( scale > 0.0 ) ;
+    for ( size_t j = 0 ; affine && (j < numKnots) ; j ++ )
+      affine  =  ( std::abs ( knotX[j] - (shift + scale * this->knotX[j]) ) <= slack ) ;
+    if ( affine )
+      return  mapAffinely ( shift, scale ) ;
+    } // end if
+  return  create ( order, knotX, K_matrix, collocationStrategy ) ;
+  } // end withKnots
+
+// ================================================================================================
+
+SplinePtr  Spline::create ( size_t order, double xMin, double xMax, size_t N )
+  {
+  return  std::make_shared<const Spline> ( order, xMin, xMax, N ) ;
+  } // end create (periodic)
+
+// ================================================================================================
+
+double Spline::B ( size_t k, size_t i, size_t alpha ) const
   // Evaluate basis function B(k,i) at x = the alpha'th collocation point.
   {
   assert ( (1 <= k) && (k <= order) ) ;  //  k can range 1 to order M
   assert ( i < (numKnots - k) ) ;        //  i can range 0 to # of knots - k - 1
   assert ( alpha < N ) ;                 //  alpha can range 0 to (N-1)
 
-  // If a # has already been calculated for B(k,i,alpha), then just return that number.
-  if ( ! std::isnan( B_k_i_alpha[k][i][alpha] ) )
-    return  ( B_k_i_alpha[k][i][alpha] ) ;
-
-  // If execution reaches this point, then no # has yet been calculated for B(k,i,alpha).
-  assert ( std::isnan(B_k_i_alpha[k][i][alpha]) ) ;
-
-  // B(k,i) will be evaluated at x = the alpha'th collocation point.
-  double x  =  collocationX[alpha] ;
+  // A periodic Spline does not keep a table of B(k,i,alpha).
+  if ( periodic )
+    return  B ( k, i, collocationX[alpha] ) ;
 
-  if ( k == 1 )
-    return (  B_k_i_alpha[1][i][alpha]  =  B ( 1, i, x )  ) ;
+  // Only B(k,j+1-k) .. B(k,j) can be nonzero in knot interval j.
+  size_t  j  =  collocationInterval [ alpha ] ;
+  if ( (i + k <= j) || (i > j) )
+    return  0.0 ;
+  return  tables().B_k_i_alpha [ k ] [ alpha * k + (i + k - 1 - j) ] ;
+  } // end B(k,i,alpha)
 
-  assert ( k >= 2 ) ;
+// ================================================================================================
 
-  double  firstTermB   =  B ( k-1, i  , alpha ) ;
-  double  secondTermB  =  B ( k-1, i+1, alpha ) ;
+const Spline::BasisTables &  Spline::tables ( ) const
+  // Tabulate B(k,i,alpha) & B_matrix on first use; every later call only reads them.
+  {
+  BasisTables &  t  =  *basisTables ;
+  std::call_once ( t.once, [&] ( )
+    {
+    if ( periodic )
+      return ;
+    // Umar's Equations (1) & (2), p. 428, at each collocation point, keeping only the k basis
+    // functions of each order k which may be nonzero there:  B(k, j+1-k+l), l = 0 .. k-1.
+    t.B_k_i_alpha.assign ( order + 1, std::vector<double>() ) ;  //  index k = 0 is not used
+    for ( size_t k = 1 ; k <= order ; k ++ )
+      t.B_k_i_alpha[k].assign ( N * k, 0.0 ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      {
+      double  x  =  collocationX [ alpha ] ;
+      size_t  j  =  collocationInterval [ alpha ] ;
+      t.B_k_i_alpha[1][alpha]  =  B ( 1, j, x ) ;
+      for ( size_t k = 2 ; k <= order ; k ++ )
+        {
+        const double *  lower  =  &t.B_k_i_alpha[k-1][alpha * (k-1)] ;
+        double *        value  =  &t.B_k_i_alpha[k][alpha * k] ;
+        for ( size_t l = 0 ; l < k ; l ++ )
+          {
+          size_t  i  =  j + 1 + l - k ;   //  B(k-1,i) is lower[l-1];  B(k-1,i+1) is lower[l]
+          if ( (l >= 1) && (lower[l-1] != 0.0) )
+            value[l]  +=  lower[l-1] * ( (x - knotX[i]) / (knotX[k+i-1] - knotX[i]) ) ;
+          if ( (l + 1 < k) && (lower[l] != 0.0) )
+            value[l]  +=  lower[l] * ( (knotX[k+i] - x) / (knotX[k+i] - knotX[i+1]) ) ;
+          } // end for l loop
+        } // end for k loop
+      } // end for alpha loop
+
+    t.B_matrix  =  Eigen::MatrixXd::Zero ( N, (N + order - 1) ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      for ( size_t l = 0 ; l < order ; l ++ )
+        t.B_matrix ( alpha, firstBasis(alpha) + l )  =  t.B_k_i_alpha [ order ] [ alpha * order + l ] ;
+    } ) ;
+  return  t ;
+  } // end tables
 
-  double firstTerm   =  firstTermB   *  ( (x - knotX[i]) / (knotX[k+i-1] - knotX[i]) ) ;
-  double secondTerm  =  secondTermB  *  ( (knotX[k+i] - x) / (knotX[k+i] - knotX[i+1]) ) ;
+// ================================================================================================
 
-  return  (  B_k_i_alpha[k][i][alpha]  =  ( firstTerm + secondTerm )  ) ;
-  } // end B(k,i,alpha)
+const Eigen::MatrixXd &  Spline::getB_matrix ( ) const
+  {
+  return  tables().B_matrix ;
+  } // end getB_matrix
 
 // ================================================================================================
 
-double Spline::B ( size_t k, size_t i, double x )
+double Spline::B ( size_t k, size_t i, double x ) const
   // Evaluate basis function B(k,i) at arbitrary real x.
   {
   assert ( (1 <= k) && (k <= order) ) ;   //  k can range 1 to order M
@@ -150,7 +518,7 @@ double Spline::B ( size_t k, size_t i, double x )
 
 // ================================================================================================
 
-double Spline::C ( size_t k, size_t i, double x )
+double Spline::C ( size_t k, size_t i, double x ) const
   // Implements Umar's Equation (5), p. 429.
   {
   assert ( k >= 1 ) ;
@@ -165,7 +533,7 @@ double Spline::C ( size_t k, size_t i, double x )
 
 // ================================================================================================
 
-double Spline::D_B ( size_t p, size_t k, size_t i, double x )
+double Spline::D_B ( size_t p, size_t k, size_t i, double x ) const
   // Evaluate p'th derivative of B(k,i) at arbitrary real x,
   // for k in the range (p+1) .. M.
   {
@@ -175,6 +543,14 @@ double Spline::D_B ( size_t p, size_t k, size_t i, double x )
   assert ( (knotX.front() <= x) && (x <= knotX.back() ) ) ;
   //  D_B is defined only for those x between the first & last knots.
 
+  if ( (k == order) && ! ppCoefficients.empty() )  //  read the piecewise-polynomial table
+    {
+    size_t  j  =  knotInterval ( x ) ;
+    if ( (i > j) || (i + order <= j) )
+      return  0.0 ;
+    return  ppDerivative ( p, j, i + order - 1 - j, x - knotX[j] ) ;
+    } // end if
+
   if ( k >= (p+2) )  //  use Umar's Equation (4), p. 428
     {
     double  firstTermRatio  =  ( x - knotX[i] ) / ( knotX[k+i-1] - knotX[i] ) ;
@@ -193,20 +569,256 @@ double Spline::D_B ( size_t p, size_t k, size_t i, double x )
 
 // ================================================================================================
 
-Eigen::MatrixXd  Spline::operatorMatrix ( size_t derivativeOrder )
+Eigen::MatrixXd  Spline::operatorMatrix ( size_t derivativeOrder ) const
   // Determine the matrix representation of differentiation operator.
   {
-  Eigen::MatrixXd  returnMatrix  =  Eigen::MatrixXd::Zero ( N, N ) ;
-  double   sum ;
-  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
-    for ( size_t beta = 0 ; beta < N ; beta ++ )
-      {
-      sum  =  0.0 ;
-      for ( int i = 0 ; i < (order + N - 1) ; i ++ )
-        sum  +=  ( C_tilde_matrix(i,beta) * D_B(derivativeOrder,order,i,collocationX[alpha]) ) ;
-      returnMatrix ( alpha, beta )  =  sum ;
-      } // end for beta loop
+  Eigen::MatrixXd  returnMatrix ( N, N ) ;
+  operatorMatrix ( derivativeOrder, returnMatrix ) ;
   return  returnMatrix ;
   } // end operatorMatrix function
 
 // ================================================================================================
+
+void  Spline::operatorMatrix ( size_t derivativeOrder, Eigen::MatrixXd & result ) const
+  // Determine the matrix representation of differentiation operator, in caller's storage.
+  {
+  result.resize ( N, N ) ;  //  no reallocation when already N by N
+
+  if ( periodic )
+    {
+    // Circulant:  column 0 of the operator determines all other columns.
+    Eigen::VectorXd  column0  =  applyOperator ( derivativeOrder, Eigen::VectorXd::Unit(N,0) ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      for ( size_t beta = 0 ; beta < N ; beta ++ )
+        result ( alpha, beta )  =  column0 ( (alpha + N - beta) % N ) ;
+    return ;
+    } // end if
+
+  // Umar's Equation (28):  O(alpha,beta) = sum over i of  D_B(alpha,i) * C_tilde(i,beta),
+  // with each derivative D_B evaluated once rather than once per beta,
+  // and the first N columns of C_tilde found by banded solves.
+  // Collocation point alpha lies in knot interval j = collocationInterval[alpha], on which only
+  // B(M,j+1-M+l), l = 0 .. M-1, are nonzero.
+  Eigen::MatrixXd  derivatives  =  Eigen::MatrixXd::Zero ( N, (N + order - 1) ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  j  =  collocationInterval [ alpha ] ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      derivatives ( alpha, firstBasis(alpha) + l )  =  ppDerivative ( derivativeOrder, j, l, collocationX[alpha] - knotX[j] ) ;
+    } // end for alpha loop
+  Eigen::MatrixXd  C_tilde  =  Eigen::MatrixXd::Zero ( (N + order - 1), N ) ;
+  C_tilde.middleRows ( (order - 1) / 2, N ).setIdentity ( ) ;
+  solveCoefficients ( C_tilde ) ;
+  result.noalias()  =  derivatives * C_tilde ;
+  } // end operatorMatrix function
+
+// ================================================================================================
+
+const Eigen::MatrixXd &  Spline::cachedOperatorMatrix ( size_t derivativeOrder ) const
+  // Compute the operator on first use; every later call only reads it.
+  {
+  assert ( derivativeOrder < order ) ;
+  OperatorCache &  cache  =  *operatorCache ;
+  std::call_once ( cache.once[derivativeOrder], [&] ( )
+    {
+    operatorMatrix ( derivativeOrder, cache.matrix[derivativeOrder] ) ;
+    cache.ready[derivativeOrder]  =  true ;
+    } ) ;
+  return  cache.matrix[derivativeOrder] ;
+  } // end cachedOperatorMatrix
+
+// ================================================================================================
+
+Eigen::VectorXd  Spline::applyOperator ( size_t derivativeOrder, const Eigen::VectorXd & u ) const
+  // Apply the differentiation operator to values at collocation points.
+  {
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  if ( periodic )
+    {
+    assert ( derivativeOrder < order ) ;
+    return  applySymbol ( operatorSymbol[derivativeOrder], u ) ;
+    } // end if
+
+  // Umar's Equation (28) applied right to left:  the coefficients C_tilde u first (a banded
+  // solve), then the M nonzero derivatives at each collocation point, so that no N by N operator
+  // is formed.
+  Eigen::VectorXd  result ( N ) ;
+  differentiateCoefficients ( derivativeOrder, coefficients ( u ), result ) ;
+  return  result ;
+  } // end applyOperator function
+
+// ================================================================================================
+
+Eigen::VectorXd  Spline::applyOperator ( size_t derivativeOrder, const Eigen::VectorXd & u,
+                                         const Eigen::VectorXd & boundaryValues ) const
+  // Apply the differentiation operator, with nonzero boundary values, to values at collocation points.
+  {
+  assert ( ! periodic ) ;
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  Eigen::VectorXd  result ( N ) ;
+  differentiateCoefficients ( derivativeOrder, coefficients ( u, boundaryValues ), result ) ;
+  return  result ;
+  } // end applyOperator function
+
+// ================================================================================================
+
+Eigen::VectorXcd  Spline::applyComplexOperator ( size_t derivativeOrder, const Eigen::VectorXcd & u ) const
+  // Apply the (real) differentiation operator to the real & imaginary parts of u.
+  {
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  if ( periodic )
+    {
+    assert ( derivativeOrder < order ) ;
+    Eigen::VectorXcd  result ( N ) ;
+    result.real()  =  applySymbol ( operatorSymbol[derivativeOrder], u.real() ) ;
+    result.imag()  =  applySymbol ( operatorSymbol[derivativeOrder], u.imag() ) ;
+    return  result ;
+    } // end if
+
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  Eigen::MatrixXd  c  =  Eigen::MatrixXd::Zero ( N + order - 1, 2 ) ;
+  c.block ( q, 0, N, 1 )  =  u.real() ;
+  c.block ( q, 1, N, 1 )  =  u.imag() ;
+  solveCoefficients ( c ) ;
+  Eigen::MatrixXd  parts ( N, 2 ) ;
+  differentiateCoefficients ( derivativeOrder, c, parts ) ;
+  Eigen::VectorXcd  result ( N ) ;
+  result.real()  =  parts.col ( 0 ) ;
+  result.imag()  =  parts.col ( 1 ) ;
+  return  result ;
+  } // end applyComplexOperator function
+
+// ================================================================================================
+
+Eigen::MatrixXd  Spline::liftingMatrix ( size_t derivativeOrder ) const
+  // Determine the response of the differentiation operator to each boundary value.
+  {
+  assert ( ! periodic ) ;
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  // Columns of C_tilde belonging to the beta_matrix rows, in the row order of B_tilde_factors.
+  Eigen::MatrixXd  C_tilde  =  Eigen::MatrixXd::Zero ( (N + order - 1), (order - 1) ) ;
+  for ( size_t r = 0 ; r < q ; r ++ )
+    {
+    C_tilde ( r,         r     )  =  1.0 ;
+    C_tilde ( q + N + r, q + r )  =  1.0 ;
+    } // end for r loop
+  solveCoefficients ( C_tilde ) ;
+  Eigen::MatrixXd  result ( N, (order - 1) ) ;
+  differentiateCoefficients ( derivativeOrder, C_tilde, result ) ;
+  return  result ;
+  } // end liftingMatrix function
+
+// ================================================================================================
+
+void  Spline::differentiateCoefficients ( size_t derivativeOrder, const Eigen::Ref<const Eigen::MatrixXd> & c,
+                                          Eigen::Ref<Eigen::MatrixXd> result ) const
+  // Differentiate splines, given their coefficients, at the collocation points.
+  {
+  assert ( (static_cast<size_t>(c.rows()) == (N + order - 1)) && (result.rows() == static_cast<long>(N))
+           && (result.cols() == c.cols()) ) ;
+  // Collocation point alpha lies in knot interval j = collocationInterval[alpha], on which only
+  // B(M,j+1-M+l), l = 0 .. M-1, are nonzero.
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  j  =  collocationInterval [ alpha ] ;
+    result.row ( alpha ).setZero ( ) ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      result.row ( alpha )  +=  ppDerivative ( derivativeOrder, j, l, collocationX[alpha] - knotX[j] )
+                                * c.row ( firstBasis(alpha) + l ) ;
+    } // end for alpha loop
+  } // end differentiateCoefficients
+
+// ================================================================================================
+
+Eigen::VectorXd  Spline::solvePeriodic ( size_t derivativeOrder, const Eigen::VectorXd & f, double shift ) const
+  // Invert the shifted circulant operator, mode by mode.
+  {
+  assert ( periodic ) ;
+  assert ( derivativeOrder < order ) ;
+  assert ( static_cast<size_t>(f.size()) == N ) ;
+
+  // Modes whose eigenvalue is negligible relative to the largest are discarded.
+  Eigen::VectorXcd  shifted  =  operatorSymbol[derivativeOrder].array() + shift ;
+  double  tolerance  =  shifted.cwiseAbs().maxCoeff() * N * std::numeric_limits<double>::epsilon() ;
+  Eigen::VectorXcd  inverseSymbol ( N ) ;
+  for ( size_t k = 0 ; k < N ; k ++ )
+    inverseSymbol(k)  =  ( std::abs(shifted(k)) > tolerance ) ? ( 1.0 / shifted(k) ) : ( 0.0 ) ;
+  return  applySymbol ( inverseSymbol, f ) ;
+  } // end solvePeriodic function
+
+// ================================================================================================
+
+Eigen::VectorXd  Spline::applySymbol ( const Eigen::VectorXcd & symbol, const Eigen::VectorXd & u ) const
+  // Multiply by a circulant matrix, given its eigenvalues.
+  {
+  // Eigen's forward FFT uses exp(-2 pi i k alpha / N), so the Fourier coefficient k of u
+  // multiplies mode exp(+2 pi i k alpha / N), whose eigenvalue is symbol(k).
+  Eigen::FFT<double>  fft ;
+  Eigen::VectorXcd    uComplex  =  u.cast< std::complex<double> >() ;
+  Eigen::VectorXcd    uHat ;
+  fft.fwd ( uHat, uComplex ) ;
+  uHat  =  uHat.cwiseProduct ( symbol ) ;
+  fft.inv ( uComplex, uHat ) ;
+  return  uComplex.real() ;
+  } // end applySymbol function
+
+// ================================================================================================
+
+Eigen::VectorXd  Spline::coefficients ( const Eigen::VectorXd & u, const Eigen::VectorXd & boundaryValues ) const
+  // Solve Umar's Equation (20) for the spline coefficients.
+  {
+  assert ( ! periodic ) ;
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  assert ( (boundaryValues.size() == 0) || (static_cast<size_t>(boundaryValues.size()) == (order - 1)) ) ;
+
+  const size_t  q  =  ( order - 1 ) / 2 ;
+  Eigen::VectorXd  c  =  Eigen::VectorXd::Zero ( N + order - 1 ) ;
+  c.segment ( q, N )  =  u ;
+  if ( boundaryValues.size() > 0 )
+    {
+    c.head ( q )  =  boundaryValues.head ( q ) ;
+    c.tail ( q )  =  boundaryValues.tail ( q ) ;
+    } // end if
+  solveCoefficients ( c ) ;
+  return  c ;
+  } // end coefficients function
+
+// ================================================================================================
+
+double  Spline::evaluate ( const Eigen::VectorXd & coefficients, size_t p, double x ) const
+  // Sum the nonzero terms of the spline expansion (or of its p'th derivative) at x.
+  {
+  assert ( ! periodic ) ;
+  assert ( static_cast<size_t>(coefficients.size()) == (N + order - 1) ) ;
+  assert ( p < order ) ;
+  assert ( (knotX.front() <= x) && (x <= knotX.back()) ) ;
+
+  // Interval j with knotX[j] <= x < knotX[j+1] (the last interval, if x is the last knot);
+  // only B(M,i) for i = j-M+1 .. j can be nonzero there.
+  size_t  j  =  knotInterval ( x ) ;
+  double  sum  =  0.0 ;
+  for ( size_t l = 0 ; l < order ; l ++ )
+    {
+    size_t  i  =  j + 1 + l - order ;
+    if ( (j + 1 + l >= order) && (i < (N + order - 1)) )
+      sum  +=  coefficients(i) * ppDerivative ( p, j, l, x - knotX[j] ) ;
+    } // end for l loop
+  return  sum ;
+  } // end evaluate function
+
+// ================================================================================================
+
+size_t  Spline::nonzeroBasis ( size_t p, double x, double * values ) const
+  {
+  assert ( ! periodic ) ;
+  assert ( p < order ) ;
+  assert ( (xMin <= x) && (x <= xMax) ) ;
+
+  // Keep to the intervals of the physical region, so that x = xMax uses the last of them.
+  size_t  j  =  std::max ( std::min ( knotInterval ( x ), numKnots - order - 1 ), order - 1 ) ;
+  for ( size_t l = 0 ; l < order ; l ++ )
+    values[l]  =  ppDerivative ( p, j, l, x - knotX[j] ) ;
+  return  j + 1 - order ;
+  } // end nonzeroBasis
+
+// ================================================================================================
@@ -16,12 +16,32 @@
 #define  SPLINE_H
 
 #include <vector>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include <Eigen/Dense>
 #include <Eigen/LU>
+#include "BandedLU.h"
+#include "CollocationStrategy.h"
 
 namespace BSCM
   {
 
+  class  Spline ;
+
+  /**
+   * @brief
+   * Shared handle to an immutable %Spline
+   *
+   * All of the member functions of a %Spline are const.  The banded tables its operations need are
+   * computed when it is constructed; the dense tables (<b><em>getB_matrix</em></b>, <b><em>B</em></b>
+   * at collocation points) and the operator matrices of <b><em>cachedOperatorMatrix</em></b> are
+   * computed on first use, each exactly once under a std::once_flag, and only read thereafter.  So any
+   * number of threads may use one %Spline through a SplinePtr without locking (see splineThreadTest.cpp).
+   */
+  typedef  std::shared_ptr<const Spline>  SplinePtr ;
+
   /**
    * @brief
    * Class %Spline implements the <em>Basis %Spline Collocation Method</em> (BSCM).
@@ -35,7 +55,7 @@ namespace BSCM
   class  Spline
     {
 
-    public :  //  ----------------------------------  Data Members  ----------------------------------------------
+    private :  //  ---------------------------------  Data Members  ----------------------------------------------
 
       /**
         * @brief
@@ -76,12 +96,28 @@ namespace BSCM
         * &nbsp;&nbsp;{&nbsp;<b><em>x<sub>&nbsp;&alpha;</sub></em></b>&nbsp;}&nbsp;&nbsp;
         * within the physical boundaries along the x-axis
         *
-        * Following Umar's suggestion (Equation (13), p. 431), each collocation point is located
-        * midway between two knots.\n
+        * By default, following Umar's suggestion (Equation (13), p. 431), each collocation point
+        * is located midway between two knots; see <b><em>collocationStrategy</em></b>.\n
         * Uses zero-based indexing, <b><em>in contrast to Umar's one-based indexing</em></b>.\n
         */
       std::vector<double>  collocationX ;
 
+      /**
+        * @brief
+        * Rule by which <b><em>collocationX</em></b> was placed
+        */
+      CollocationStrategy  collocationStrategy ;
+
+      /**
+        * @brief
+        * Index <em>j</em> of the knot interval containing each collocation point
+        *
+        * Only the basis functions <em>j</em>&nbsp;+&nbsp;1&nbsp;&minus;&nbsp;<b><em>M</em></b> ..
+        * <em>j</em> are nonzero at that point.  For midpoint collocation,
+        * <em>j</em> = <b><em>M</em></b>&nbsp;&minus;&nbsp;1&nbsp;+&nbsp;&alpha;.
+        */
+      std::vector<size_t>  collocationInterval ;
+
       /**
         * @brief
         * <b><em>Number of collocation points</em></b> along the <em>x</em>-axis
@@ -106,8 +142,14 @@ namespace BSCM
         * @par  Subscript <b><em>&nbsp;i&nbsp;</em></b>
         *   Subscript <b><em>&nbsp;i&nbsp;</em></b> is an index selecting basis function
         *   &nbsp;<em><b>B<sub>&nbsp;i</sub><sup>M</sup>&nbsp;</b></em>.\n
+        * @par  Storage
+        *   Row &alpha; has only <b><em>M</em></b> nonzero elements, and the banded, matrix-free
+        *   operations read them from the piecewise-polynomial table.  So the dense matrix (with the
+        *   table of <b><em>B</em></b>(&nbsp;<em>k</em>,&nbsp;<em>i</em>,&nbsp;&alpha;&nbsp;)) is held
+        *   in <b><em>basisTables</em></b>, and computed only when first requested.
         */
-      Eigen::MatrixXd  B_matrix ;
+      struct  BasisTables ;
+      std::shared_ptr<BasisTables>  basisTables ;
 
       /**
         * @brief
@@ -148,6 +190,19 @@ namespace BSCM
         */
       Eigen::MatrixXd  beta_matrix ;
 
+      /**
+        * @brief
+        * <b><em>true</em></b> when the basis wraps around periodically
+        *
+        * A periodic %Spline has <b><em>N</em></b> uniform knot intervals between
+        * <em>xMin</em> &amp; <em>xMax</em>, and <b><em>N</em></b> basis functions which wrap
+        * around from the right boundary back to the left boundary.\n
+        * The collocation operators of a periodic %Spline are circulant, so they are applied
+        * &amp; inverted by FFT, and <b><em>getB_matrix</em></b>, <b><em>K_matrix</em></b>
+        * &amp; <b><em>beta_matrix</em></b> are left empty.
+        */
+      bool  periodic ;
+
     public :  //  ----------------------------------  Member Functions  ------------------------------------------
 
       /**
@@ -160,9 +215,161 @@ namespace BSCM
         * @param K_matrix Specifies fixed boundary conditions
         *                 (denoted&nbsp; <em><b>K<sub>&nbsp;r&nbsp;p</sub></b></em>
         *                 &nbsp;in Umar's Equation (16), p. 432)
+        * @param strategy Places the collocation points; they must satisfy
+        *                 CollocationStrategy::schoenbergWhitney
         */
-      Spline ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix ) ;
-    
+      Spline ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix,
+               const CollocationStrategy & strategy = CollocationStrategy::midpoint ( ) ) ;
+
+      /**
+        * @brief
+        * Construct a periodic BSCM %Spline object on uniformly spaced knots
+        *
+        * The physical region [&nbsp;<em>xMin</em>, <em>xMax</em>&nbsp;) is divided into
+        * <b><em>N</em></b> equal intervals, and (<b><em>M</em></b>&minus;1) further knots
+        * are placed (with the same spacing) beyond each physical boundary.\n
+        * Collocation points are again the midpoints of the physical intervals.
+        * @param order  %Spline order (denoted <em><b>M</b></em> by Umar et al, p. 427)
+        * @param xMin   Left physical boundary
+        * @param xMax   Right physical boundary, identified with <em>xMin</em>
+        * @param N      Number of knot intervals (and of collocation points) per period;
+        *               must be at least <em><b>M</b></em>
+        */
+      Spline ( size_t order, double xMin, double xMax, size_t N ) ;
+
+      /**
+        * @brief
+        * Construct a BSCM %Spline with the knots of <em>basis</em> but new boundary conditions
+        *
+        * The basis function tables of <em>basis</em> are copied rather than recomputed;
+        * only <b><em>beta_matrix</em></b> &amp; the (banded) factors depending on it are rebuilt.\n
+        * Since only the <b><em>M</em></b>&minus;1 rows of <b><em>beta_matrix</em></b> change,
+        * each operator already cached by <em>basis</em> (see <b><em>cachedOperatorMatrix</em></b>)
+        * is carried over by a Sherman&ndash;Morrison&ndash;Woodbury update of rank
+        * <b><em>M</em></b>&minus;1, in O(<b><em>N</em></b><sup>2</sup>&nbsp;<b><em>M</em></b>) operations,
+        * rather than recomputed.
+        * @param basis    A non-periodic %Spline
+        * @param K_matrix Specifies fixed boundary conditions
+        *                 (denoted&nbsp; <em><b>K<sub>&nbsp;r&nbsp;p</sub></b></em>
+        *                 &nbsp;in Umar's Equation (16), p. 432)
+        */
+      Spline ( const Spline & basis, Eigen::MatrixXi K_matrix ) ;
+
+      /**
+        * @brief
+        * Construct a shareable %Spline; see the constructor with the same parameters
+        */
+      static SplinePtr  create ( size_t order, std::vector<double> knotX, Eigen::MatrixXi K_matrix,
+                                 const CollocationStrategy & strategy = CollocationStrategy::midpoint ( ) ) ;
+
+      /**
+        * @brief
+        * Construct a shareable periodic %Spline; see the constructor with the same parameters
+        */
+      static SplinePtr  create ( size_t order, double xMin, double xMax, size_t N ) ;
+
+      /**
+        * @brief
+        * Construct a shareable %Spline with new boundary conditions; see the constructor
+        * with the same parameters
+        */
+      static SplinePtr  create ( const Spline & basis, Eigen::MatrixXi K_matrix ) ;
+
+      /**
+        * @brief
+        * A shareable %Spline with the knots of this one but new boundary conditions
+        *
+        * This %Spline is immutable, so it is not itself changed; see the constructor
+        * Spline(&nbsp;const Spline &amp;, Eigen::MatrixXi&nbsp;) for what is reused.
+        * @param K_matrix Specifies the new fixed boundary conditions
+        * @return  SplinePtr
+        */
+      SplinePtr  updateBoundaryConditions ( Eigen::MatrixXi K_matrix ) const ;
+
+      /**
+        * @brief
+        * A shareable %Spline whose knots are the images of this one's under
+        * <em>x</em> &rarr; <em>shift</em> + <em>scale</em>&nbsp;<em>x</em>, with the same boundary conditions
+        *
+        * Basis function values at the (mapped) collocation points are unchanged, so
+        * <b><em>B_matrix</em></b> &amp; the other basis tables are shared or copied, and the
+        * piecewise-polynomial coefficients of degree <em>d</em> are multiplied by
+        * <em>scale</em><sup>&nbsp;&minus;<em>d</em></sup>.  When each row of <b><em>K_matrix</em></b>
+        * involves a single derivative order (as for Dirichlet or Neumann conditions), each operator
+        * already cached by this %Spline is carried over as
+        * <em>scale</em><sup>&nbsp;&minus;<em>p</em></sup>&nbsp;<em>O</em><sup>&nbsp;(<em>p</em>)</sup>,
+        * in O(<b><em>N</em></b><sup>2</sup>) operations; otherwise the new %Spline computes its
+        * operators afresh when they are first requested.
+        * @param shift  Translation
+        * @param scale  Magnification; must be positive
+        * @return  SplinePtr
+        */
+      SplinePtr  mapAffinely ( double shift, double scale ) const ;
+
+      /**
+        * @brief
+        * A shareable %Spline with the given knots and this one's boundary conditions
+        *
+        * If <em>knotX</em> is (to rounding) an affine image of this %Spline's knots, the result is
+        * that of <b><em>mapAffinely</em></b>; otherwise it is a newly constructed %Spline, whose
+        * collocation points are placed by this one's <b><em>collocationStrategy</em></b>.
+        * @param knotX  Knots of the new %Spline
+        * @return  SplinePtr
+        */
+      SplinePtr  withKnots ( const std::vector<double> & knotX ) const ;
+
+      /** @brief %Spline order <b><em>M</em></b>; see <b><em>order</em></b> */
+      size_t  getOrder ( ) const  { return  order ; }
+
+      /** @brief Sequence of knot points; see <b><em>knotX</em></b> */
+      const std::vector<double> &  getKnotX ( ) const  { return  knotX ; }
+
+      /** @brief Number of knot points; see <b><em>numKnots</em></b> */
+      size_t  getNumKnots ( ) const  { return  numKnots ; }
+
+      /** @brief Sequence of collocation points; see <b><em>collocationX</em></b> */
+      const std::vector<double> &  getCollocationX ( ) const  { return  collocationX ; }
+
+      /** @brief Rule placing the collocation points; see <b><em>collocationStrategy</em></b> */
+      const CollocationStrategy &  getCollocationStrategy ( ) const  { return  collocationStrategy ; }
+
+      /**
+        * @brief
+        * Index of the first of the <b><em>M</em></b> basis functions nonzero at collocation point &alpha;
+        *
+        * Row &alpha; of <b><em>B_matrix</em></b> (and of each derivative of the basis) is nonzero only in
+        * columns firstBasis(&alpha;) .. firstBasis(&alpha;)&nbsp;+&nbsp;<b><em>M</em></b>&nbsp;&minus;&nbsp;1,
+        * and firstBasis(&alpha;) differs from &alpha; by at most (<b><em>M</em></b>&minus;1)/2.
+        * @return  size_t
+        */
+      size_t  firstBasis ( size_t alpha ) const  { return  collocationInterval [ alpha ] + 1 - order ; }
+
+      /** @brief Number of collocation points <b><em>N</em></b>; see <b><em>N</em></b> */
+      size_t  getN ( ) const  { return  N ; }
+
+      /**
+        * @brief The matrix&nbsp; <b><em>B<sub>&nbsp;&alpha;&nbsp;i</sub></em></b>; see <b><em>B_matrix</em></b>
+        *
+        * Formed on the first call, in O(<b><em>N</em></b><sup>&nbsp;2</sup>) memory; nothing else needs it.
+        * Empty for a periodic %Spline.
+        */
+      const Eigen::MatrixXd &  getB_matrix ( ) const ;
+
+      /** @brief The matrix&nbsp; <b><em>K<sub>&nbsp;r&nbsp;p</sub></em></b>; see <b><em>K_matrix</em></b> */
+      const Eigen::MatrixXi &  getK_matrix ( ) const  { return  K_matrix ; }
+
+      /** @brief The matrix&nbsp; <b><em>&beta;<sub>&nbsp;r&nbsp;i</sub></em></b>; see <b><em>beta_matrix</em></b> */
+      const Eigen::MatrixXd &  getBeta_matrix ( ) const  { return  beta_matrix ; }
+
+      /** @brief Whether the basis wraps around; see <b><em>periodic</em></b> */
+      bool  isPeriodic ( ) const  { return  periodic ; }
+
+      /** @brief Left physical boundary <em>xMin</em> */
+      double  getXMin ( ) const  { return  xMin ; }
+
+      /** @brief Right physical boundary <em>xMax</em> */
+      double  getXMax ( ) const  { return  xMax ; }
+
       /**
         * @brief
         * <em><b>B<sub>&nbsp;i</sub><sup>k</sup>&nbsp;(x)</b></em>,
@@ -184,7 +391,7 @@ namespace BSCM
         *          whereas another version of overloaded&nbsp; <b><em>B</em></b> &nbsp;has
         *          third parameter of type size_t.
         */
-      double B ( size_t k, size_t i, double x ) ;
+      double B ( size_t k, size_t i, double x ) const ;
 
       /**
         * @brief
@@ -207,7 +414,7 @@ namespace BSCM
         *          whereas another version of overloaded&nbsp; <b><em>B</em></b> &nbsp;has
         *          third parameter of type double.
         */
-      double B ( size_t k, size_t i, size_t alpha ) ;
+      double B ( size_t k, size_t i, size_t alpha ) const ;
 
       /**
         * @brief
@@ -217,7 +424,9 @@ namespace BSCM
         * &nbsp;<em><b>B<sub>&nbsp;i</sub><sup>k</sup></b></em>, 
         * &nbsp;evaluated at&nbsp; <b><em>x</em></b>
         * 
-        * See Umar's Equations (4), (5), (6), &amp; (7), pp. 428-429.
+        * See Umar's Equations (4), (5), (6), &amp; (7), pp. 428-429.\n
+        * For <em>k</em> = <b><em>M</em></b> (and a non-periodic %Spline), the value is instead
+        * read from the piecewise-polynomial table by Horner's scheme, in O(<b><em>M</em></b>) operations.
         * @param  p  Derivative order, ranging 0, ..., (<b><em>M</em></b>&minus;1)\n
         *            <em>p</em> = 0 is 0<sup>th</sup> derivative,&nbsp; 
         *            <em>p</em> = 1 is 1<sup>st</sup> derivative, etc.
@@ -233,7 +442,7 @@ namespace BSCM
         *          &nbsp;<em>B<sub>&nbsp;i</sub><sup>k</sup>&nbsp;(&nbsp;x&nbsp;)</em>
         *          &nbsp; is comprised (piecewise) of polynomials of degree <em>k</em> &minus; 1.
         */
-      double D_B ( size_t p, size_t k, size_t i, double x ) ;
+      double D_B ( size_t p, size_t k, size_t i, double x ) const ;
 
       /**
         * @brief Matrix representation of differentiation operator
@@ -252,22 +461,172 @@ namespace BSCM
         *          <em>f</em>(<em>M</em>+<em>N</em>&minus;2) &nbsp;have all been set equal zero,
         *          as shown in Umar's Equation (21), p. 433.
         */
-      Eigen::MatrixXd  operatorMatrix ( size_t derivativeOrder ) ;
+      Eigen::MatrixXd  operatorMatrix ( size_t derivativeOrder ) const ;
 
-    private :  //  -----------------------------------------------------------------------------------------------
+      /**
+        * @brief Matrix representation of differentiation operator, written into caller's storage
+        *
+        * Same as <b><em>operatorMatrix</em></b>(&nbsp;<em>derivativeOrder</em>&nbsp;), but
+        * <em>result</em> is reused (and is reallocated only if it is not already
+        * <b><em>N</em></b> by <b><em>N</em></b>).
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @param   result  Receives the operator matrix
+        */
+      void  operatorMatrix ( size_t derivativeOrder, Eigen::MatrixXd & result ) const ;
+
+      /**
+        * @brief Matrix representation of differentiation operator, computed once and kept
+        *
+        * The first call for each <em>derivativeOrder</em> computes
+        * <b><em>operatorMatrix</em></b>(&nbsp;<em>derivativeOrder</em>&nbsp;); later calls
+        * return the same matrix.  Safe to call from any number of threads at once.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @return  const Eigen::MatrixXd &amp;  valid for the lifetime of the %Spline
+        */
+      const Eigen::MatrixXd &  cachedOperatorMatrix ( size_t derivativeOrder ) const ;
+
+      /**
+        * @brief Apply differentiation operator to a vector of values at collocation points
+        *
+        * Computes <em>O<sub>&nbsp;&alpha;</sub><sup>&nbsp;&beta;</sup></em>&nbsp;<em>u<sub>&beta;</sub></em>.\n
+        * For a periodic %Spline, the circulant operator is applied in O(<em>N</em> log <em>N</em>)
+        * operations by FFT; otherwise, the spline coefficients of <em>u</em> are found with the banded
+        * factors of Umar's "B tilde" and then differentiated at the collocation points, in
+        * O(<b><em>N</em></b>&nbsp;<b><em>M</em></b>) operations and without forming
+        * <b><em>operatorMatrix</em></b>.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @param   u  Values at the <b><em>N</em></b> collocation points
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  applyOperator ( size_t derivativeOrder, const Eigen::VectorXd & u ) const ;
 
+      /**
+        * @brief Apply differentiation operator to collocation values, with nonzero boundary values
+        *
+        * Umar's Equation (21), p. 433, sets the combinations of boundary derivatives selected by
+        * <b><em>K_matrix</em></b> to zero.  Here they are set to <em>boundaryValues</em> instead, and
+        * the result is <em>O</em>&nbsp;<em>u</em> + <em>L</em>&nbsp;<em>g</em>, where <em>O</em> is
+        * <b><em>operatorMatrix</em></b>(&nbsp;<em>derivativeOrder</em>&nbsp;) and <em>L</em> is
+        * <b><em>liftingMatrix</em></b>(&nbsp;<em>derivativeOrder</em>&nbsp;).  Not available for
+        * a periodic %Spline.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @param   u               Values at the <b><em>N</em></b> collocation points
+        * @param   boundaryValues  Values <em>g</em> of the <b><em>M</em></b>&minus;1 rows of
+        *                          <b><em>beta_matrix</em></b>, in the order of its rows
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  applyOperator ( size_t derivativeOrder, const Eigen::VectorXd & u,
+                                       const Eigen::VectorXd & boundaryValues ) const ;
+
+      /**
+        * @brief Apply differentiation operator to complex values at collocation points
+        *
+        * The operator is real, so it is applied to the real &amp; imaginary parts together,
+        * as a block of two right-hand sides, at the cost of the real <b><em>applyOperator</em></b>.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @param   u  Complex values at the <b><em>N</em></b> collocation points
+        * @return  Eigen::VectorXcd
+        */
+      Eigen::VectorXcd  applyComplexOperator ( size_t derivativeOrder, const Eigen::VectorXcd & u ) const ;
+
+      /**
+        * @brief Response of a differentiation operator to nonzero boundary values
+        *
+        * The <b><em>N</em></b> by (<b><em>M</em></b>&minus;1) matrix <em>L</em> whose column
+        * <em>r</em> is the <em>derivativeOrder</em>'th derivative, at the collocation points, of the
+        * spline vanishing at every collocation point and having boundary value 1 in row <em>r</em> of
+        * <b><em>beta_matrix</em></b> (0 in the other rows).\n
+        * With <em>L</em> computed once, a change of the boundary values <em>g</em> changes
+        * <em>O</em>&nbsp;<em>u</em> + <em>L</em>&nbsp;<em>g</em> by the correction
+        * <em>L</em>&nbsp;&Delta;<em>g</em>, at a cost of
+        * O(<b><em>N</em></b>&nbsp;<b><em>M</em></b>) and with no refactoring.
+        * Not available for a periodic %Spline.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @return  Eigen::MatrixXd
+        */
+      Eigen::MatrixXd  liftingMatrix ( size_t derivativeOrder ) const ;
+
+      /**
+        * @brief Solve&nbsp; (&nbsp;<em>O</em> + <em>shift</em>&nbsp;)&nbsp;<em>u</em> = <em>f</em>
+        *        &nbsp;for a periodic %Spline
+        *
+        * The circulant operator is inverted by FFT in O(<em>N</em> log <em>N</em>) operations.\n
+        * Fourier modes for which (<em>O</em> + <em>shift</em>) vanishes (e.g. the constant mode,
+        * when <em>shift</em> = 0) are set to zero in <em>u</em>,
+        * so that <em>u</em> is the minimum-norm least-squares solution.
+        * @param   derivativeOrder 1 indicates &part;/&part;<em>x</em>,&nbsp;
+        *          2 indicates &part;<sup>2</sup>/&part;<em>x</em><sup>2</sup>,&nbsp; etc.
+        * @param   f      Right-hand side at the <b><em>N</em></b> collocation points
+        * @param   shift  Constant added to the diagonal of the operator
+        * @return  Eigen::VectorXd
+        */
+      Eigen::VectorXd  solvePeriodic ( size_t derivativeOrder, const Eigen::VectorXd & f,
+                                       double shift = 0.0 ) const ;
+
+      /** @brief Smallest permitted %Spline order <b><em>M</em></b> */
       static const size_t MIN_ORDER      =   3 ;
+
+      /** @brief Largest permitted %Spline order <b><em>M</em></b> */
       static const size_t MAX_ORDER      =  15 ;
 
       /**
-        * This is the matrix "B tilde" of Umar, Equation (20), p. 433.
+        * @brief Spline coefficients&nbsp; <em>f<sup>&nbsp;i</sup></em> &nbsp;for given collocation
+        *        &amp; boundary values
+        *
+        * Solves Umar's Equation (20), p. 433, with the right-hand sides of the
+        * <b><em>beta_matrix</em></b> rows set to <em>boundaryValues</em> rather than to zero.
+        * Not available for a periodic %Spline.
+        * @param   u               Values at the <b><em>N</em></b> collocation points
+        * @param   boundaryValues  Values of the <b><em>M</em></b>&minus;1 combinations of derivatives
+        *                          selected by <b><em>K_matrix</em></b>; empty for all zero
+        * @return  Eigen::VectorXd  of the <b><em>N</em></b> + <b><em>M</em></b> &minus; 1 coefficients
+        */
+      Eigen::VectorXd  coefficients ( const Eigen::VectorXd & u,
+                                      const Eigen::VectorXd & boundaryValues = Eigen::VectorXd() ) const ;
+
+      /**
+        * @brief <em>p<sup>&nbsp;th</sup></em> derivative, at <em>x</em>, of the spline
+        *        with the given coefficients
+        *
+        * Sums <em>f<sup>&nbsp;i</sup></em>&nbsp;&part;<sup>&nbsp;p</sup>&nbsp;<em>B<sub>&nbsp;i</sub><sup>M</sup></em>(<em>x</em>)
+        * over the <b><em>M</em></b> basis functions which may be nonzero at <em>x</em>.
+        * @param   coefficients  Result of <b><em>coefficients</em></b>
+        * @param   p             Derivative order, ranging 0, ..., (<b><em>M</em></b>&minus;1)
+        * @param   x             Location between the first &amp; last knots
+        * @return  double
         */
-      Eigen::MatrixXd  B_tilde_matrix ;
+      double  evaluate ( const Eigen::VectorXd & coefficients, size_t p, double x ) const ;
 
       /**
-        * This is the matrix "C tilde" of Umar, Equation (22), p. 433.
+        * @brief <em>p<sup>&nbsp;th</sup></em> derivatives, at <em>x</em>, of the
+        *        <b><em>M</em></b> basis functions which may be nonzero there
+        *
+        * Each is read from the piecewise-polynomial table, so the cost is
+        * O(<b><em>M</em></b><sup>&nbsp;2</sup>).  Not available for a periodic %Spline.
+        * @param   p       Derivative order, ranging 0, ..., (<b><em>M</em></b>&minus;1)
+        * @param   x       Location between <em>xMin</em> &amp; <em>xMax</em>
+        * @param   values  Receives&nbsp; &part;<sup>&nbsp;p</sup>&nbsp;<em>B<sub>&nbsp;i</sub><sup>M</sup></em>(<em>x</em>)
+        *                  &nbsp;for <em>i</em> = <em>first</em>, ..., <em>first</em> + <b><em>M</em></b> &minus; 1
+        * @return  size_t  <em>first</em>, between 0 &amp; <b><em>N</em></b> &minus; 1
         */
-      Eigen::MatrixXd  C_tilde_matrix ;
+      size_t  nonzeroBasis ( size_t p, double x, double * values ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      /**
+        * LU factors of the matrix "B tilde" of Umar, Equation (20), p. 433, with its rows reordered
+        * as [&nbsp;left rows of beta;&nbsp; B;&nbsp; right rows of beta&nbsp;] so that it is banded,
+        * with <b><em>M</em></b>&minus;1 diagonals on each side of the main diagonal.\n
+        * Solving with these factors takes the place of multiplying by
+        * "C tilde" (Umar, Equation (22)), which is never formed.
+        */
+      BandedLU<double>  B_tilde_factors ;
 
       /**
         * This is the leftmost physical boundary; see Umar p 430.
@@ -279,20 +638,121 @@ namespace BSCM
         */
      double           xMax ;
 
-      static const size_t MAX_NUMBER_KNOTS  =  100 ;
-
       /**
         * This function implements the recursion relation to find lower order derivatives
         * as shown in Umar p. 429, Equations (5, 6, and 7).
         * @return  double
         */
-      double C ( size_t k, size_t i, double x ) ;
+      double C ( size_t k, size_t i, double x ) const ;
+
+      /**
+        * The dense basis tables, computed together on first use (under the once_flag) and then
+        * only read.  A %Spline sharing this one's knots &amp; collocation points shares them too.\n
+        * B_k_i_alpha[k][alpha&nbsp;k + l] = B ( k, i, alpha ) for i = collocationInterval[alpha] + 1 &minus; k + l,
+        * the k basis functions of order k which may be nonzero at collocation point alpha.
+        */
+      struct  BasisTables
+        {
+        std::once_flag                     once ;
+        Eigen::MatrixXd                    B_matrix ;
+        std::vector< std::vector<double> >  B_k_i_alpha ;
+        } ;
+
+      /**
+        * The basis tables, computed if this is their first use.
+        */
+      const BasisTables &  tables ( ) const ;
+
+      /**
+        * Piecewise-polynomial (PP) form of the basis functions of order <b><em>M</em></b>.\n
+        * On knot interval <em>j</em> (<em>x<sub>j</sub></em> &le; <em>x</em> &lt; <em>x<sub>j+1</sub></em>),
+        * the <b><em>M</em></b> basis functions that may be nonzero are
+        * <em>B<sub>&nbsp;i</sub><sup>M</sup></em> for <em>i</em> = <em>j</em> &minus; <b><em>M</em></b> + 1 + <em>l</em>,
+        * <em>l</em> = 0 .. <b><em>M</em></b>&minus;1, and\n
+        * <em>B<sub>&nbsp;i</sub><sup>M</sup></em>(<em>x</em>) = &sum;<sub><em>d</em></sub>
+        * ppCoefficients[ (<em>j</em>&nbsp;<b><em>M</em></b> + <em>l</em>)&nbsp;<b><em>M</em></b> + <em>d</em> ]
+        * &nbsp;(<em>x</em> &minus; <em>x<sub>j</sub></em>)<sup><em>d</em></sup>.\n
+        * Empty for a periodic %Spline.
+        */
+      std::vector<double>  ppCoefficients ;
+
+      /**
+        * Eigenvalues of the circulant operators of a periodic %Spline:
+        * operatorSymbol[p](k) is the eigenvalue of operatorMatrix(p)
+        * belonging to Fourier mode exp(2&pi;<em>i</em>k&alpha;/<em>N</em>).
+        * Empty for a non-periodic %Spline.
+        */
+      std::vector<Eigen::VectorXcd>  operatorSymbol ;
+
+      /**
+        * Operator matrices computed on demand by cachedOperatorMatrix, indexed by derivative
+        * order.  Each is written exactly once (under its once_flag) and then only read.
+        */
+      struct  OperatorCache
+        {
+        std::once_flag     once [ MAX_ORDER ] ;
+        std::atomic<bool>  ready [ MAX_ORDER ] ;
+        Eigen::MatrixXd    matrix [ MAX_ORDER ] ;
+        OperatorCache ( )  { for ( size_t p = 0 ; p < MAX_ORDER ; p ++ )  ready[p]  =  false ; }
+        } ;
+      std::shared_ptr<OperatorCache>  operatorCache ;
+
+      /**
+        * Assign beta_matrix &amp; B_tilde_factors from K_matrix and the basis tables.
+        */
+      void  assembleBoundaryConditions ( ) ;
+
+      /**
+        * Fill this %Spline's operator cache from the operators cached by <em>basis</em>, which has
+        * the same knots but different beta_matrix rows, by a rank-(M&minus;1) Woodbury update.
+        */
+      void  inheritOperators ( const Spline & basis ) ;
+
+      /**
+        * Construct the image of <em>basis</em> under x &rarr; shift + scale x; see mapAffinely.
+        */
+      Spline ( const Spline & basis, double shift, double scale ) ;
+
+      /**
+        * Fill ppCoefficients by the recursion of Umar's Equation (1), p. 428,
+        * applied to polynomials rather than to values.
+        */
+      void  tabulatePiecewisePolynomials ( ) ;
+
+      /**
+        * Index <em>j</em> of the knot interval containing <em>x</em>:
+        * <em>x<sub>j</sub></em> &le; <em>x</em> &lt; <em>x<sub>j+1</sub></em>, or the last interval
+        * when <em>x</em> is the last knot.
+        */
+      size_t  knotInterval ( double x ) const ;
+
+      /**
+        * <em>p<sup>&nbsp;th</sup></em> derivative of the <em>l<sup>&nbsp;th</sup></em> basis function
+        * nonzero on knot interval <em>j</em>, at <em>t</em> = <em>x</em> &minus; <em>x<sub>j</sub></em>,
+        * by Horner's scheme on ppCoefficients in O(<b><em>M</em></b>) operations.
+        */
+      double  ppDerivative ( size_t p, size_t j, size_t l, double t ) const ;
+
+      /**
+        * Transform <em>u</em> by FFT, multiply by <em>symbol</em>, and transform back.
+        */
+      Eigen::VectorXd  applySymbol ( const Eigen::VectorXcd & symbol, const Eigen::VectorXd & u ) const ;
+
+      /**
+        * Overwrite each column of <em>rhs</em>, ordered as the rows of B_tilde_factors
+        * (left boundary values, collocation values, right boundary values),
+        * with the spline coefficients.
+        */
+      void  solveCoefficients ( Eigen::Ref<Eigen::MatrixXd> rhs ) const ;
 
       /**
-        * Vector storing values of B( size_t k, size_t i, size_t alpha )
-        * B_k_i_alpha[k][i][alpha] = B ( k, i, alpha )
+        * Row &alpha; of <em>result</em> is the sum over the <b><em>M</em></b> basis functions
+        * nonzero at <em>x<sub>&alpha;</sub></em> of their derivatives there times the
+        * corresponding rows of the coefficients <em>c</em>, in O(<b><em>N</em></b>&nbsp;<b><em>M</em></b>)
+        * operations per column.
         */
-      std::vector< std::vector< std::vector<double> > >  B_k_i_alpha ;
+      void  differentiateCoefficients ( size_t derivativeOrder, const Eigen::Ref<const Eigen::MatrixXd> & c,
+                                        Eigen::Ref<Eigen::MatrixXd> result ) const ;
 
     } ; // end Spline class
 
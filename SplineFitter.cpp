@@ -0,0 +1,197 @@
+/**
+ * @file    SplineFitter.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File SplineFitter.cpp contains the definition of the SplineFitter class,
+ * which fits a spline to scattered samples by least squares.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include "SplineFitter.h"
+#include "BandedLDLT.h"
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor
+SplineFitter::SplineFitter ( SplinePtr spline )
+  : spline ( spline ), order ( spline->getOrder() ),
+    numCoefficients ( spline->getN() + spline->getOrder() - 1 ), samples ( 0 ),
+    normal ( Eigen::MatrixXd::Zero ( spline->getOrder(), spline->getN() + spline->getOrder() - 1 ) ),
+    rhs ( Eigen::VectorXd::Zero ( spline->getN() + spline->getOrder() - 1 ) ),
+    bandwidth ( 0 ), basis ( spline->getOrder() )
+  {
+  assert ( ! spline->isPeriodic() ) ;
+  const size_t  n  =  numCoefficients ;
+  substitution.resize ( n ) ;
+
+  // Only the coefficients nearest each boundary appear in beta_matrix.
+  const Eigen::MatrixXd &  beta  =  spline->getBeta_matrix() ;
+  const size_t             r     =  beta.rows() ;
+  std::vector<size_t>  columns ;
+  for ( size_t i = 0 ; i < n ; i ++ )
+    if ( ! beta.col(i).isZero ( 0.0 ) )
+      columns.push_back ( i ) ;
+  Eigen::MatrixXd  local ( r, columns.size() ) ;
+  for ( size_t m = 0 ; m < columns.size() ; m ++ )
+    local.col(m)  =  beta.col ( columns[m] ) ;
+
+  // Full pivoting chooses the M-1 of them to eliminate; the pivot columns come first in Q.
+  Eigen::FullPivLU<Eigen::MatrixXd>  lu ( local ) ;
+  assert ( static_cast<size_t>(lu.rank()) == r ) ;
+  Eigen::MatrixXd      pivotBlock ( r, r ), otherBlock ( r, columns.size() - r ) ;
+  std::vector<size_t>  others ;
+  for ( size_t m = 0 ; m < columns.size() ; m ++ )
+    {
+    size_t  c  =  lu.permutationQ().indices() ( m ) ;
+    if ( m < r )
+      {
+      constrained.push_back ( columns[c] ) ;
+      pivotBlock.col(m)  =  local.col(c) ;
+      } // end if
+    else
+      {
+      others.push_back ( columns[c] ) ;
+      otherBlock.col(m - r)  =  local.col(c) ;
+      } // end else
+    } // end for m loop
+  boundaryInverse  =  pivotBlock.partialPivLu().inverse() ;
+  Eigen::MatrixXd  elimination  =  - boundaryInverse * otherBlock ;
+
+  // Rows of Z:  the free coefficients are numbered in order.
+  std::vector<bool>  isConstrained ( n, false ) ;
+  for ( size_t k = 0 ; k < r ; k ++ )
+    isConstrained [ constrained[k] ]  =  true ;
+  std::vector<size_t>  reducedIndex ( n ) ;
+  for ( size_t i = 0, a = 0 ; i < n ; i ++ )
+    if ( ! isConstrained[i] )
+      {
+      reducedIndex[i]  =  a ++ ;
+      substitution[i].push_back ( std::make_pair ( reducedIndex[i], 1.0 ) ) ;
+      } // end if
+  for ( size_t k = 0 ; k < r ; k ++ )
+    for ( size_t m = 0 ; m < others.size() ; m ++ )
+      if ( elimination ( k, m ) != 0.0 )
+        substitution [ constrained[k] ].push_back ( std::make_pair ( reducedIndex[others[m]], elimination(k,m) ) ) ;
+
+  // Band of Z^T A Z, from the band of A.
+  for ( size_t i = 0 ; i < n ; i ++ )
+    for ( size_t j = i ; (j < n) && (j < i + order) ; j ++ )
+      for ( size_t s = 0 ; s < substitution[i].size() ; s ++ )
+        for ( size_t t = 0 ; t < substitution[j].size() ; t ++ )
+          {
+          size_t  a  =  substitution[i][s].first, b  =  substitution[j][t].first ;
+          bandwidth  =  std::max ( bandwidth, (a > b) ? (a - b) : (b - a) ) ;
+          } // end for t loop
+  } // end constructor
+
+// ================================================================================================
+
+void  SplineFitter::add ( const double * x, const double * y, size_t count, const double * weights )
+  {
+  for ( size_t s = 0 ; s < count ; s ++ )
+    {
+    // Only B(M,i) for i = first .. first+M-1 can be nonzero at x[s].
+    size_t  first  =  spline->nonzeroBasis ( 0, x[s], &basis[0] ) ;
+    double  w      =  ( weights != 0 ) ? weights[s] : 1.0 ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      {
+      double  wb  =  w * basis[l] ;
+      rhs ( first + l )  +=  wb * y[s] ;
+      for ( size_t m = l ; m < order ; m ++ )
+        normal ( m - l, first + l )  +=  wb * basis[m] ;
+      } // end for l loop
+    } // end for s loop
+  samples  +=  count ;
+  } // end add
+
+// ================================================================================================
+
+void  SplineFitter::add ( const Eigen::VectorXd & x, const Eigen::VectorXd & y )
+  {
+  assert ( x.size() == y.size() ) ;
+  add ( x.data(), y.data(), x.size() ) ;
+  } // end add
+
+// ================================================================================================
+
+bool  SplineFitter::solve ( double regularization, const Eigen::VectorXd & boundaryValues )
+  {
+  assert ( regularization >= 0.0 ) ;
+  const size_t  n  =  numCoefficients ;
+  const size_t  r  =  constrained.size() ;
+  assert ( (boundaryValues.size() == 0) || (static_cast<size_t>(boundaryValues.size()) == r) ) ;
+
+  // f = Z a + p minimizes the weighted residual when  Z^T A Z a = Z^T ( b - A p ).
+  Eigen::VectorXd  particular  =  Eigen::VectorXd::Zero ( n ) ;
+  if ( boundaryValues.size() != 0 )
+    {
+    Eigen::VectorXd  lifted  =  boundaryInverse * boundaryValues ;
+    for ( size_t k = 0 ; k < r ; k ++ )
+      particular ( constrained[k] )  =  lifted ( k ) ;
+    } // end if
+
+  BandedLDLT<double>  factors ( n - r, bandwidth ) ;
+  Eigen::VectorXd     reducedRhs  =  Eigen::VectorXd::Zero ( n - r ) ;
+  for ( size_t i = 0 ; i < n ; i ++ )
+    {
+    double  residual  =  rhs ( i ) ;
+    size_t  first     =  ( i + 1 > order ) ? ( i + 1 - order ) : 0 ;
+    for ( size_t j = first ; (j < n) && (j < i + order) ; j ++ )
+      {
+      double  a_ij  =  ( j >= i ) ? normal ( j - i, i ) : normal ( i - j, j ) ;
+      if ( i == j )
+        a_ij  +=  regularization ;
+      residual  -=  a_ij * particular ( j ) ;
+      // Only the lower triangle of Z^T A Z is stored.
+      for ( size_t s = 0 ; s < substitution[i].size() ; s ++ )
+        for ( size_t t = 0 ; t < substitution[j].size() ; t ++ )
+          if ( substitution[i][s].first >= substitution[j][t].first )
+            factors.coeffRef ( substitution[i][s].first, substitution[j][t].first )
+              +=  substitution[i][s].second * a_ij * substitution[j][t].second ;
+      } // end for j loop
+    for ( size_t s = 0 ; s < substitution[i].size() ; s ++ )
+      reducedRhs ( substitution[i][s].first )  +=  substitution[i][s].second * residual ;
+    } // end for i loop
+  if ( ! factors.factorize() )
+    return  false ;
+  Eigen::VectorXd  reduced  =  factors.solve ( reducedRhs ) ;
+
+  fitted  =  particular ;
+  for ( size_t i = 0 ; i < n ; i ++ )
+    for ( size_t s = 0 ; s < substitution[i].size() ; s ++ )
+      fitted ( i )  +=  substitution[i][s].second * reduced ( substitution[i][s].first ) ;
+
+  // Collocation values, from the M nonzero basis functions at each point.
+  const size_t                 N   =  spline->getN() ;
+  const std::vector<double> &  xA  =  spline->getCollocationX() ;
+  values.resize ( N ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    {
+    size_t  first  =  spline->nonzeroBasis ( 0, xA[alpha], &basis[0] ) ;
+    double  sum    =  0.0 ;
+    for ( size_t l = 0 ; l < order ; l ++ )
+      sum  +=  basis[l] * fitted ( first + l ) ;
+    values ( alpha )  =  sum ;
+    } // end for alpha loop
+  return  true ;
+  } // end solve
+
+// ================================================================================================
+
+void  SplineFitter::clear ( )
+  {
+  normal.setZero ( ) ;
+  rhs.setZero ( ) ;
+  samples  =  0 ;
+  } // end clear
+
+// ================================================================================================
@@ -0,0 +1,154 @@
+/**
+ * @file    SplineFitter.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File SplineFitter.h contains the declaration of the SplineFitter class,
+ * which fits a spline to scattered samples by least squares.
+ */
+
+#ifndef  SPLINEFITTER_H
+#define  SPLINEFITTER_H
+
+#include <vector>
+#include <utility>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %SplineFitter finds the spline&nbsp;
+   * <em>f</em>(<em>x</em>) = &sum;<sub><em>i</em></sub>&nbsp;<em>f<sup>&nbsp;i</sup></em>&nbsp;<em>B<sub>&nbsp;i</sub><sup>M</sup></em>(<em>x</em>)
+   * &nbsp;minimizing&nbsp; &sum;<sub><em>s</em></sub>&nbsp;<em>w<sub>s</sub></em>&nbsp;(&nbsp;<em>f</em>(<em>x<sub>s</sub></em>) &minus; <em>y<sub>s</sub></em>&nbsp;)<sup>2</sup>
+   * &nbsp;over any number of samples (<em>x<sub>s</sub></em>,&nbsp;<em>y<sub>s</sub></em>).
+   *
+   * Samples may be given in chunks of any size, in any order.  At most <b><em>M</em></b> basis
+   * functions are nonzero at a sample, so each sample adds O(<b><em>M</em></b><sup>&nbsp;2</sup>)
+   * terms to the normal equations, whose matrix is symmetric &amp; banded, with
+   * <b><em>M</em></b>&minus;1 diagonals on each side of the main diagonal.  Only that band
+   * and the right-hand side are stored, so memory does not depend on the number of samples.\n\n
+   * The fit satisfies the boundary conditions of the %Spline:&nbsp;
+   * <b><em>beta_matrix</em></b>&nbsp;<em>f</em> = <em>g</em>, for boundary values <em>g</em>
+   * (zero unless given to <b><em>solve</em></b>).  Each row of <b><em>beta_matrix</em></b>
+   * involves only the <b><em>M</em></b> coefficients of the basis functions nonzero at its
+   * boundary, so <b><em>M</em></b>&minus;1 of those coefficients are eliminated in favour of
+   * their neighbours, once, by the constructor.  The remaining <b><em>N</em></b> coefficients are
+   * fitted freely; their normal matrix is still symmetric, positive definite &amp; banded
+   * (with at most 3&nbsp;(<b><em>M</em></b>&minus;1) diagonals on each side, the extra ones only
+   * near the boundaries), and is factored by BandedLDLT.  <b><em>solve</em></b> costs
+   * O(<b><em>N</em></b>&nbsp;<b><em>M</em></b><sup>&nbsp;2</sup>).\n
+   * The <b><em>collocationValues</em></b> and the boundary values then determine the fit exactly,
+   * as Spline::coefficients, so they may serve as initial values for a time loop.
+   */
+
+  class  SplineFitter
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Construct a fitter for the basis of <em>spline</em>, with no samples
+        *
+        * @param spline  Non-periodic %Spline whose basis is fitted
+        */
+      explicit SplineFitter ( SplinePtr spline ) ;
+
+      /**
+        * @brief
+        * Add a chunk of samples
+        *
+        * @param x        Locations, between <em>xMin</em> &amp; <em>xMax</em>
+        * @param y        Values
+        * @param count    Number of samples
+        * @param weights  Weight of each sample, or 0 for all 1
+        */
+      void  add ( const double * x, const double * y, size_t count, const double * weights = 0 ) ;
+
+      /**
+        * @brief
+        * Add a chunk of samples, each of weight 1
+        */
+      void  add ( const Eigen::VectorXd & x, const Eigen::VectorXd & y ) ;
+
+      /** @brief Number of samples added since construction or the last <b><em>clear</em></b> */
+      size_t  numSamples ( ) const  { return  samples ; }
+
+      /**
+        * @brief
+        * Solve the normal equations for the coefficients, subject to the boundary conditions
+        *
+        * Knot intervals holding too few samples leave the normal equations singular;
+        * a positive <em>regularization</em> &lambda; adds&nbsp;
+        * &lambda;&nbsp;&sum;<sub><em>i</em></sub>&nbsp;(<em>f<sup>&nbsp;i</sup></em>)<sup>2</sup>
+        * &nbsp;to the sum minimized, which makes them solvable.
+        * @param regularization  &lambda;
+        * @param boundaryValues  Values of the <b><em>M</em></b>&minus;1 combinations of derivatives
+        *                        selected by <b><em>K_matrix</em></b>; empty for all zero
+        * @return  bool  false if the normal equations are singular
+        */
+      bool  solve ( double regularization = 0.0,
+                    const Eigen::VectorXd & boundaryValues = Eigen::VectorXd() ) ;
+
+      /**
+        * @brief
+        * The <b><em>N</em></b> + <b><em>M</em></b> &minus; 1 fitted coefficients;
+        * requires <b><em>solve</em></b>
+        */
+      const Eigen::VectorXd &  coefficients ( ) const  { return  fitted ; }
+
+      /**
+        * @brief
+        * Values of the fitted spline at the <b><em>N</em></b> collocation points;
+        * requires <b><em>solve</em></b>
+        */
+      const Eigen::VectorXd &  collocationValues ( ) const  { return  values ; }
+
+      /**
+        * @brief
+        * Discard all samples
+        */
+      void  clear ( ) ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      SplinePtr  spline ;
+      size_t     order ;
+      size_t     numCoefficients ;
+      size_t     samples ;
+
+      /**
+        * Upper band of the normal matrix:  element (i, i+d) at normal ( d, i ), d = 0 .. M-1.
+        */
+      Eigen::MatrixXd  normal ;
+      Eigen::VectorXd  rhs ;
+
+      /**
+        * The boundary conditions, solved for the M-1 coefficients in constrained:&nbsp;
+        * f = Z a + p, with a the N fitted coefficients and p zero but for
+        * p[constrained[k]] = (boundaryInverse g)(k).  Row i of Z is substitution[i], as
+        * (index into a, weight) pairs:  a single (a index, 1) for a free coefficient.
+        */
+      std::vector<size_t>                                      constrained ;
+      Eigen::MatrixXd                                          boundaryInverse ;
+      std::vector< std::vector< std::pair<size_t, double> > >  substitution ;
+      size_t                                                   bandwidth ;  //  of Z^T A Z
+
+      std::vector<double>  basis ;  //  scratch for the M basis values at a sample
+
+      Eigen::VectorXd  fitted ;
+      Eigen::VectorXd  values ;
+
+    } ; // end SplineFitter class
+
+  } // end namespace BSCM
+
+#endif  //  SPLINEFITTER_H
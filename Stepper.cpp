@@ -0,0 +1,103 @@
+/**
+ * @file    Stepper.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File Stepper.cpp contains the definition of the Stepper class,
+ * which advances BSCM collocation values through time.
+ */
+
+#include <cassert>
+#include "Stepper.h"
+#include <unsupported/Eigen/MatrixFunctions>
+
+using namespace BSCM ;
+
+// ================================================================================================
+
+// constructor
+Stepper::Stepper ( std::shared_ptr<const Eigen::MatrixXd> propagator, const Eigen::VectorXd & u0 )
+  : propagator ( propagator ), u ( u0 ), scratch ( u0.size() ), steps ( 0 )
+  {
+  assert ( propagator && (propagator->rows() == u0.size()) && (propagator->cols() == u0.size()) ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// constructor with forcing by boundary values
+Stepper::Stepper ( std::shared_ptr<const Eigen::MatrixXd> propagator,
+                   std::shared_ptr<const Eigen::MatrixXd> forcing, const Eigen::VectorXd & u0 )
+  : propagator ( propagator ), forcing ( forcing ), u ( u0 ), scratch ( u0.size() ), steps ( 0 )
+  {
+  assert ( propagator && (propagator->rows() == u0.size()) && (propagator->cols() == u0.size()) ) ;
+  assert ( forcing && (forcing->rows() == u0.size()) ) ;
+  } // end constructor
+
+// ================================================================================================
+
+std::shared_ptr<const Eigen::MatrixXd>
+  Stepper::heatPropagator ( const Spline & spline, double diffusivity, double dt )
+  {
+  Eigen::MatrixXd  D ( spline.getN(), spline.getN() ) ;
+  spline.operatorMatrix ( 2, D ) ;
+  return  std::make_shared<const Eigen::MatrixXd> ( ( (diffusivity * dt) * D ).exp() ) ;
+  } // end heatPropagator
+
+// ================================================================================================
+
+std::shared_ptr<const Eigen::MatrixXd>
+  Stepper::heatForcing ( const Spline & spline, double diffusivity, double dt )
+  {
+  const size_t  N  =  spline.getN() ;
+  const size_t  m  =  spline.getOrder() - 1 ;
+  Eigen::MatrixXd  augmented  =  Eigen::MatrixXd::Zero ( N + m, N + m ) ;
+  augmented.topLeftCorner  ( N, N )  =  ( diffusivity * dt ) * spline.operatorMatrix ( 2 ) ;
+  augmented.topRightCorner ( N, m )  =  ( diffusivity * dt ) * spline.liftingMatrix ( 2 ) ;
+  return  std::make_shared<const Eigen::MatrixXd> ( augmented.exp().topRightCorner ( N, m ) ) ;
+  } // end heatForcing
+
+// ================================================================================================
+
+void  Stepper::step ( )
+  {
+  // noalias: the product is written straight into scratch, with no temporary;
+  // swap exchanges the two vectors' storage without copying.
+  scratch.noalias()  =  (*propagator) * u ;
+  u.swap ( scratch ) ;
+  steps ++ ;
+  } // end step
+
+// ================================================================================================
+
+void  Stepper::step ( const Eigen::VectorXd & boundaryValues )
+  {
+  assert ( forcing && (boundaryValues.size() == forcing->cols()) ) ;
+  scratch.noalias()   =  (*propagator) * u ;
+  scratch.noalias()  +=  (*forcing) * boundaryValues ;
+  u.swap ( scratch ) ;
+  steps ++ ;
+  } // end step
+
+// ================================================================================================
+
+void  Stepper::step ( uint64_t count )
+  {
+  for ( uint64_t s = 0 ; s < count ; s ++ )
+    step ( ) ;
+  } // end step
+
+// ================================================================================================
+
+void  Stepper::reset ( const Eigen::VectorXd & u0, uint64_t stepCount )
+  {
+  assert ( u0.size() == u.size() ) ;
+  u      =  u0 ;  //  same size, so Eigen reuses the existing storage
+  steps  =  stepCount ;
+  } // end reset
+
+// ================================================================================================
@@ -0,0 +1,145 @@
+/**
+ * @file    Stepper.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File Stepper.h contains the declaration of the Stepper class,
+ * which advances BSCM collocation values through time.
+ */
+
+#ifndef  STEPPER_H
+#define  STEPPER_H
+
+#include <memory>
+#include <stdint.h>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %Stepper repeatedly applies a fixed propagator matrix to a vector of
+   * collocation values.
+   *
+   * All storage (the state and one scratch vector) is allocated by the constructor,
+   * so that <b><em>step</em></b> performs no heap allocation.
+   * The propagator is held through a shared pointer, so any number of concurrent
+   * simulations may share one propagator, each owning only its two vectors.\n
+   * Eigen's malloc permission (EIGEN_RUNTIME_NO_MALLOC) is one flag for the whole process, so
+   * <b><em>step</em></b> leaves it alone; a single-threaded caller may forbid allocation around
+   * its own steps.\n\n
+   * With a forcing matrix <em>G</em> as well, each step may be given boundary values
+   * <em>g</em> (held constant over the step):&nbsp;
+   * <em>u</em> &larr; <em>P</em>&nbsp;<em>u</em> + <em>G</em>&nbsp;<em>g</em>.  Changing <em>g</em>
+   * from one step to the next costs nothing beyond the product with <em>G</em>, which is
+   * <b><em>N</em></b> by (<b><em>M</em></b>&minus;1).
+   */
+
+  class  Stepper
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Construct a %Stepper which applies <em>propagator</em> to <em>u0</em>
+        *
+        * @param propagator  <b><em>N</em></b> by <b><em>N</em></b> matrix applied at every step
+        * @param u0          Initial collocation values
+        */
+      Stepper ( std::shared_ptr<const Eigen::MatrixXd> propagator, const Eigen::VectorXd & u0 ) ;
+
+      /**
+        * @brief
+        * Construct a %Stepper which applies <em>propagator</em> &amp; <em>forcing</em> to <em>u0</em>
+        *
+        * @param propagator  <b><em>N</em></b> by <b><em>N</em></b> matrix <em>P</em> applied at every step
+        * @param forcing     Matrix <em>G</em> applied to the boundary values given to each step
+        * @param u0          Initial collocation values
+        */
+      Stepper ( std::shared_ptr<const Eigen::MatrixXd> propagator,
+                std::shared_ptr<const Eigen::MatrixXd> forcing, const Eigen::VectorXd & u0 ) ;
+
+      /**
+        * @brief
+        * The heat-equation propagator&nbsp; exp(&nbsp;&kappa;&nbsp;<em>dt</em>&nbsp;<em>O</em><sup>&nbsp;(2)</sup>&nbsp;)
+        *
+        * @param spline       %Spline supplying <em>O</em><sup>&nbsp;(2)</sup> = operatorMatrix(2)
+        * @param diffusivity  Thermal diffusivity &kappa;
+        * @param dt           Time step
+        * @return  std::shared_ptr<const Eigen::MatrixXd>
+        */
+      static std::shared_ptr<const Eigen::MatrixXd>
+        heatPropagator ( const Spline & spline, double diffusivity, double dt ) ;
+
+      /**
+        * @brief
+        * The heat-equation forcing by boundary values held constant over a step
+        *
+        * With <em>A</em> = &kappa;&nbsp;<em>O</em><sup>&nbsp;(2)</sup> and <em>L</em> =
+        * liftingMatrix(2), <em>u</em>&prime; = <em>A</em>&nbsp;<em>u</em> + &kappa;&nbsp;<em>L</em>&nbsp;<em>g</em>,
+        * so one step adds&nbsp; <em>G</em>&nbsp;<em>g</em>, where&nbsp;
+        * <em>G</em> = <em>dt</em>&nbsp;&phi;<sub>1</sub>(<em>dt</em>&nbsp;<em>A</em>)&nbsp;&kappa;&nbsp;<em>L</em>
+        * &nbsp;and&nbsp; &phi;<sub>1</sub>(<em>z</em>) = (<em>e<sup>z</sup></em> &minus; 1)&nbsp;/&nbsp;<em>z</em>.
+        * <em>G</em> is read from the exponential of the augmented matrix
+        * [&nbsp;<em>dt</em>&nbsp;<em>A</em>,&nbsp; <em>dt</em>&nbsp;&kappa;&nbsp;<em>L</em>&nbsp;;&nbsp; 0,&nbsp; 0&nbsp;].
+        * @param spline       Non-periodic %Spline supplying <em>O</em><sup>&nbsp;(2)</sup> &amp; <em>L</em>
+        * @param diffusivity  Thermal diffusivity &kappa;
+        * @param dt           Time step
+        * @return  std::shared_ptr<const Eigen::MatrixXd>  of dimensions <b><em>N</em></b> by (<b><em>M</em></b>&minus;1)
+        */
+      static std::shared_ptr<const Eigen::MatrixXd>
+        heatForcing ( const Spline & spline, double diffusivity, double dt ) ;
+
+      /**
+        * @brief
+        * Advance the state by one step:&nbsp; <em>u</em> &larr; <em>P</em>&nbsp;<em>u</em>
+        */
+      void  step ( ) ;
+
+      /**
+        * @brief
+        * Advance the state by <em>count</em> steps
+        */
+      void  step ( uint64_t count ) ;
+
+      /**
+        * @brief
+        * Advance the state by one step with boundary values <em>g</em>:&nbsp;
+        * <em>u</em> &larr; <em>P</em>&nbsp;<em>u</em> + <em>G</em>&nbsp;<em>g</em>;
+        * requires a forcing matrix
+        */
+      void  step ( const Eigen::VectorXd & boundaryValues ) ;
+
+      /** @brief Current collocation values */
+      const Eigen::VectorXd &  state ( ) const  { return  u ; }
+
+      /** @brief Number of steps taken since construction or the last <b><em>reset</em></b> */
+      uint64_t  stepCount ( ) const  { return  steps ; }
+
+      /**
+        * @brief
+        * Replace the state (copied into the existing storage) and the step count
+        */
+      void  reset ( const Eigen::VectorXd & u0, uint64_t stepCount = 0 ) ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      std::shared_ptr<const Eigen::MatrixXd>  propagator ;
+      std::shared_ptr<const Eigen::MatrixXd>  forcing ;     //  empty unless given
+      Eigen::VectorXd                         u ;
+      Eigen::VectorXd                         scratch ;
+      uint64_t                                steps ;
+
+    } ; // end Stepper class
+
+  } // end namespace BSCM
+
+#endif  //  STEPPER_H
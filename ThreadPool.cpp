@@ -0,0 +1,162 @@
+/**
+ * @file    ThreadPool.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File ThreadPool.cpp contains the definition of the ThreadPool class
+ * used to schedule independent BSCM computations.
+ */
+
+#include <cassert>
+#include "ThreadPool.h"
+
+using namespace BSCM ;
+
+namespace
+  {
+  // Identify the pool & worker (if any) running on the current thread,
+  // so that tasks submitted from within a task stay on their worker's queue.
+  thread_local const ThreadPool *  currentPool    =  0 ;
+  thread_local size_t              currentWorker  =  0 ;
+  } // end anonymous namespace
+
+// ================================================================================================
+
+// constructor
+ThreadPool::ThreadPool ( size_t numThreads )
+  {
+  if ( numThreads == 0 )
+    numThreads  =  std::thread::hardware_concurrency() ;
+  if ( numThreads == 0 )  //  hardware_concurrency may be unable to tell
+    numThreads  =  1 ;
+
+  numQueued   =  0 ;
+  numPending  =  0 ;
+  stopping    =  false ;
+  nextQueue   =  0 ;
+
+  for ( size_t index = 0 ; index < numThreads ; index ++ )
+    queues.push_back ( std::unique_ptr<TaskQueue> ( new TaskQueue ) ) ;
+  for ( size_t index = 0 ; index < numThreads ; index ++ )
+    workers.push_back ( std::thread ( &ThreadPool::workerLoop, this, index ) ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// destructor
+ThreadPool::~ThreadPool ( )
+  {
+  wait ( ) ;
+    {
+    std::lock_guard<std::mutex>  lock ( stateMutex ) ;
+    stopping  =  true ;
+    }
+  taskAvailable.notify_all ( ) ;
+  for ( size_t index = 0 ; index < workers.size() ; index ++ )
+    workers[index].join ( ) ;
+  } // end destructor
+
+// ================================================================================================
+
+void  ThreadPool::submit ( std::function<void()> task )
+  {
+  // Count the task before queueing it, so that it cannot finish before being counted.
+  size_t  index  =  currentWorker ;
+    {
+    std::lock_guard<std::mutex>  lock ( stateMutex ) ;
+    numQueued  ++ ;
+    numPending ++ ;
+    if ( currentPool != this )
+      {
+      index  =  nextQueue ;
+      nextQueue  =  ( nextQueue + 1 ) % queues.size() ;
+      } // end if
+    }
+
+    {
+    std::lock_guard<std::mutex>  lock ( queues[index]->mutex ) ;
+    queues[index]->tasks.push_back ( task ) ;
+    }
+  taskAvailable.notify_one ( ) ;
+  } // end submit
+
+// ================================================================================================
+
+void  ThreadPool::wait ( )
+  {
+  // A worker waiting on its own pool would wait for itself.
+  assert ( currentPool != this ) ;
+  std::unique_lock<std::mutex>  lock ( stateMutex ) ;
+  while ( numPending > 0 )
+    allFinished.wait ( lock ) ;
+  } // end wait
+
+// ================================================================================================
+
+bool  ThreadPool::takeTask ( size_t index, std::function<void()> & task )
+  {
+  // Newest task from own queue (its data is most likely still in cache) ...
+    {
+    std::lock_guard<std::mutex>  lock ( queues[index]->mutex ) ;
+    if ( ! queues[index]->tasks.empty() )
+      {
+      task  =  queues[index]->tasks.back() ;
+      queues[index]->tasks.pop_back ( ) ;
+      return  true ;
+      } // end if
+    }
+
+  // ... else oldest task from some other worker's queue.
+  for ( size_t offset = 1 ; offset < queues.size() ; offset ++ )
+    {
+    TaskQueue &  victim  =  * queues[ (index + offset) % queues.size() ] ;
+    std::lock_guard<std::mutex>  lock ( victim.mutex ) ;
+    if ( ! victim.tasks.empty() )
+      {
+      task  =  victim.tasks.front() ;
+      victim.tasks.pop_front ( ) ;
+      return  true ;
+      } // end if
+    } // end for offset loop
+
+  return  false ;
+  } // end takeTask
+
+// ================================================================================================
+
+void  ThreadPool::workerLoop ( size_t index )
+  {
+  currentPool    =  this ;
+  currentWorker  =  index ;
+
+  for ( ; ; )
+    {
+    std::function<void()>  task ;
+    if ( takeTask ( index, task ) )
+      {
+        {
+        std::lock_guard<std::mutex>  lock ( stateMutex ) ;
+        numQueued -- ;
+        }
+      task ( ) ;
+      std::lock_guard<std::mutex>  lock ( stateMutex ) ;
+      if ( -- numPending == 0 )
+        allFinished.notify_all ( ) ;
+      continue ;
+      } // end if
+
+    // Every queue looked empty; sleep until a task is queued or the pool stops.
+    std::unique_lock<std::mutex>  lock ( stateMutex ) ;
+    while ( (numQueued == 0) && ! stopping )
+      taskAvailable.wait ( lock ) ;
+    if ( (numQueued == 0) && stopping )
+      return ;
+    } // end for loop
+  } // end workerLoop
+
+// ================================================================================================
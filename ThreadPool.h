@@ -0,0 +1,120 @@
+/**
+ * @file    ThreadPool.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File ThreadPool.h contains the declaration of the ThreadPool class
+ * used to schedule independent BSCM computations.
+ */
+
+#ifndef  THREADPOOL_H
+#define  THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %ThreadPool runs submitted tasks on a fixed set of worker threads.
+   *
+   * Each worker owns a double-ended queue of tasks.  A worker takes its newest task first,
+   * and, when its own queue is empty, steals the oldest task from another worker's queue.\n
+   * Tasks submitted from within a task go to the submitting worker's own queue;
+   * tasks submitted from outside the pool are dealt to the workers in turn.
+   */
+
+  class  ThreadPool
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Start the worker threads
+        *
+        * @param numThreads  Number of workers; 0 selects one per hardware thread
+        */
+      explicit ThreadPool ( size_t numThreads = 0 ) ;
+
+      /**
+        * @brief
+        * Finish all submitted tasks, then stop the worker threads
+        */
+      ~ThreadPool ( ) ;
+
+      /**
+        * @brief
+        * Queue a task for execution by some worker
+        */
+      void  submit ( std::function<void()> task ) ;
+
+      /**
+        * @brief
+        * Block until every submitted task (including tasks they submit) has finished
+        */
+      void  wait ( ) ;
+
+      /**
+        * @brief
+        * Number of worker threads
+        */
+      size_t  size ( ) const  { return  workers.size() ; }
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      ThreadPool ( const ThreadPool & ) ;              // not copyable
+      ThreadPool &  operator= ( const ThreadPool & ) ; // not assignable
+
+      /**
+        * One worker's tasks; guarded by its own mutex so that workers seldom contend.
+        */
+      struct  TaskQueue
+        {
+        std::mutex                          mutex ;
+        std::deque< std::function<void()> >  tasks ;
+        } ;
+
+      std::vector< std::unique_ptr<TaskQueue> >  queues ;
+      std::vector<std::thread>                   workers ;
+
+      /**
+        * Guards numQueued, numPending & stopping.
+        */
+      std::mutex               stateMutex ;
+      std::condition_variable  taskAvailable ;
+      std::condition_variable  allFinished ;
+
+      size_t  numQueued ;   //  tasks waiting in some queue
+      size_t  numPending ;  //  tasks submitted but not yet finished
+      bool    stopping ;
+      size_t  nextQueue ;   //  queue to receive the next task submitted from outside the pool
+
+      /**
+        * Body of worker thread number <em>index</em>.
+        */
+      void  workerLoop ( size_t index ) ;
+
+      /**
+        * Take a task from worker <em>index</em>'s own queue, or else steal one.
+        * @return  false if every queue was empty
+        */
+      bool  takeTask ( size_t index, std::function<void()> & task ) ;
+
+    } ; // end ThreadPool class
+
+  } // end namespace BSCM
+
+#endif  //  THREADPOOL_H
@@ -0,0 +1,354 @@
+/**
+ * @file    TimeSeries.cpp
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File TimeSeries.cpp contains the definitions of the TimeSeriesWriter and
+ * TimeSeriesReader classes, which stream BSCM time steps to and from a binary file.
+ */
+
+#include <cassert>
+#include <cstring>
+#include "TimeSeries.h"
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+using namespace BSCM ;
+
+namespace
+  {
+  const char      MAGIC [ 8 ]  =  { 'B', 'S', 'C', 'M', 'T', 'S', '0', '1' } ;
+  const uint32_t  VERSION      =  1 ;
+
+  // Append the bytes of value to buffer.
+  template < typename T >
+  void  append ( std::vector<char> & buffer, const T & value )
+    {
+    const char *  bytes  =  reinterpret_cast<const char *> ( &value ) ;
+    buffer.insert ( buffer.end(), bytes, bytes + sizeof(T) ) ;
+    } // end append
+
+  // Copy the next value out of the mapped header, advancing offset.
+  template < typename T >
+  bool  extract ( const char * base, size_t size, size_t & offset, T & value )
+    {
+    if ( offset + sizeof(T) > size )
+      return  false ;
+    std::memcpy ( &value, base + offset, sizeof(T) ) ;
+    offset  +=  sizeof(T) ;
+    return  true ;
+    } // end extract
+
+  size_t  roundUpTo8 ( size_t bytes )
+    {
+    return  ( bytes + 7 ) & ~ static_cast<size_t>(7) ;
+    } // end roundUpTo8
+  } // end anonymous namespace
+
+// ================================================================================================
+
+// constructor
+TimeSeriesWriter::TimeSeriesWriter ( const std::string & fileName, const Spline & spline, double dt,
+                                     size_t decimation, size_t framesPerBatch )
+  {
+  assert ( (decimation >= 1) && (framesPerBatch >= 1) ) ;
+
+  this->N               =  spline.getN() ;
+  this->dt              =  dt ;
+  this->decimation      =  decimation ;
+  this->framesPerBatch  =  framesPerBatch ;
+  this->frameBytes      =  sizeof(uint64_t) + sizeof(double) + N * sizeof(double) ;
+  this->fillFrames      =  0 ;
+  this->flushFrames     =  0 ;
+  this->flushPending    =  false ;
+  this->closing         =  false ;
+  this->failed          =  false ;
+  fillBatch.resize  ( framesPerBatch * frameBytes ) ;
+  flushBatch.resize ( framesPerBatch * frameBytes ) ;
+
+  // Assemble the header.
+  const Eigen::MatrixXi &  K  =  spline.getK_matrix() ;
+  std::vector<char>  header ( MAGIC, MAGIC + sizeof(MAGIC) ) ;
+  append ( header, VERSION ) ;
+  append ( header, static_cast<uint32_t> ( spline.getOrder() ) ) ;
+  append ( header, static_cast<uint64_t> ( N ) ) ;
+  append ( header, static_cast<uint64_t> ( spline.getNumKnots() ) ) ;
+  append ( header, static_cast<uint64_t> ( K.rows() ) ) ;
+  append ( header, static_cast<uint64_t> ( K.cols() ) ) ;
+  append ( header, static_cast<uint64_t> ( spline.isPeriodic() ? 1 : 0 ) ) ;
+  append ( header, dt ) ;
+  append ( header, static_cast<uint64_t> ( decimation ) ) ;
+  for ( size_t j = 0 ; j < spline.getNumKnots() ; j ++ )
+    append ( header, spline.getKnotX()[j] ) ;
+  for ( int r = 0 ; r < K.rows() ; r ++ )
+    for ( int p = 0 ; p < K.cols() ; p ++ )
+      append ( header, static_cast<int32_t> ( K(r,p) ) ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    append ( header, spline.getCollocationX()[alpha] ) ;
+  header.resize ( roundUpTo8 ( header.size() ), 0 ) ;  //  keeps frames 8-byte aligned
+
+  file  =  std::fopen ( fileName.c_str(), "wb" ) ;
+  if ( (file == 0) || (std::fwrite ( &header[0], 1, header.size(), file ) != header.size()) )
+    failed  =  true ;
+
+  flusher  =  std::thread ( &TimeSeriesWriter::flushLoop, this ) ;
+  } // end constructor
+
+// ================================================================================================
+
+// destructor
+TimeSeriesWriter::~TimeSeriesWriter ( )
+  {
+  close ( ) ;
+  } // end destructor
+
+// ================================================================================================
+
+void  TimeSeriesWriter::write ( uint64_t step, const Eigen::VectorXd & u )
+  {
+  assert ( static_cast<size_t>(u.size()) == N ) ;
+  if ( (step % decimation) != 0 )
+    return ;
+
+  char *  frame  =  &fillBatch[ fillFrames * frameBytes ] ;
+  double  time   =  step * dt ;
+  std::memcpy ( frame, &step, sizeof(uint64_t) ) ;
+  std::memcpy ( frame + sizeof(uint64_t), &time, sizeof(double) ) ;
+  std::memcpy ( frame + sizeof(uint64_t) + sizeof(double), u.data(), N * sizeof(double) ) ;
+
+  if ( ++ fillFrames == framesPerBatch )
+    handOff ( ) ;
+  } // end write
+
+// ================================================================================================
+
+void  TimeSeriesWriter::handOff ( )
+  {
+  std::unique_lock<std::mutex>  lock ( batchMutex ) ;
+  while ( flushPending )
+    batchChanged.wait ( lock ) ;
+  fillBatch.swap ( flushBatch ) ;
+  flushFrames   =  fillFrames ;
+  fillFrames    =  0 ;
+  flushPending  =  true ;
+  batchChanged.notify_all ( ) ;
+  } // end handOff
+
+// ================================================================================================
+
+void  TimeSeriesWriter::flushLoop ( )
+  {
+  std::unique_lock<std::mutex>  lock ( batchMutex ) ;
+  for ( ; ; )
+    {
+    while ( ! flushPending && ! closing )
+      batchChanged.wait ( lock ) ;
+    if ( ! flushPending )
+      return ;  //  closing, and nothing left to write
+
+    // flushBatch belongs to this thread until flushPending is cleared.
+    size_t  bytes  =  flushFrames * frameBytes ;
+    bool    ok     =  ! failed ;
+    lock.unlock ( ) ;
+    if ( ok )
+      ok  =  ( std::fwrite ( &flushBatch[0], 1, bytes, file ) == bytes ) ;
+    lock.lock ( ) ;
+    failed        =  ! ok ;
+    flushPending  =  false ;
+    batchChanged.notify_all ( ) ;
+    } // end for loop
+  } // end flushLoop
+
+// ================================================================================================
+
+void  TimeSeriesWriter::close ( )
+  {
+  if ( ! flusher.joinable() )
+    return ;  //  already closed
+  if ( fillFrames > 0 )
+    handOff ( ) ;
+
+  std::unique_lock<std::mutex>  lock ( batchMutex ) ;
+  closing  =  true ;
+  batchChanged.notify_all ( ) ;
+  lock.unlock ( ) ;
+  flusher.join ( ) ;
+  if ( file != 0 )
+    {
+    if ( std::fclose ( file ) != 0 )
+      failed  =  true ;
+    file  =  0 ;
+    } // end if
+  } // end close
+
+// ================================================================================================
+
+bool  TimeSeriesWriter::good ( ) const
+  {
+  std::lock_guard<std::mutex>  lock ( batchMutex ) ;
+  return  ! failed ;
+  } // end good
+
+// ================================================================================================
+
+// constructor
+TimeSeriesReader::TimeSeriesReader ( const std::string & fileName )
+  : base ( 0 ), mappedBytes ( 0 ), mappingHandle ( 0 ),
+    order ( 0 ), N ( 0 ), periodic ( false ), dt ( 0.0 ), decimation ( 1 ),
+    headerBytes ( 0 ), frameBytes ( 0 ), frameCount ( 0 )
+  {
+#ifdef _WIN32
+  HANDLE  fileHandle  =  CreateFileA ( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 ) ;
+  if ( fileHandle == INVALID_HANDLE_VALUE )
+    return ;
+  LARGE_INTEGER  size ;
+  if ( GetFileSizeEx ( fileHandle, &size ) && (size.QuadPart > 0) )
+    {
+    HANDLE  mapping  =  CreateFileMappingA ( fileHandle, 0, PAGE_READONLY, 0, 0, 0 ) ;
+    if ( mapping != 0 )
+      {
+      base  =  static_cast<const char *> ( MapViewOfFile ( mapping, FILE_MAP_READ, 0, 0, 0 ) ) ;
+      if ( base != 0 )
+        {
+        mappedBytes    =  static_cast<size_t> ( size.QuadPart ) ;
+        mappingHandle  =  mapping ;
+        }
+      else
+        CloseHandle ( mapping ) ;
+      } // end if
+    } // end if
+  CloseHandle ( fileHandle ) ;  //  the mapping keeps the file open
+#else
+  int  fd  =  open ( fileName.c_str(), O_RDONLY ) ;
+  if ( fd < 0 )
+    return ;
+  struct stat  status ;
+  if ( (fstat ( fd, &status ) == 0) && (status.st_size > 0) )
+    {
+    void *  address  =  mmap ( 0, status.st_size, PROT_READ, MAP_SHARED, fd, 0 ) ;
+    if ( address != MAP_FAILED )
+      {
+      base         =  static_cast<const char *> ( address ) ;
+      mappedBytes  =  static_cast<size_t> ( status.st_size ) ;
+      } // end if
+    } // end if
+  ::close ( fd ) ;  //  the mapping keeps the file open
+#endif
+  if ( base == 0 )
+    return ;
+
+  // Read & validate the header.
+  size_t    offset  =  sizeof(MAGIC) ;
+  uint32_t  version, order32 ;
+  uint64_t  N64, numKnots, rows, cols, periodic64, decimation64 ;
+  bool  ok  =  ( mappedBytes >= sizeof(MAGIC) ) && ( std::memcmp ( base, MAGIC, sizeof(MAGIC) ) == 0 )
+            && extract ( base, mappedBytes, offset, version ) && ( version == VERSION )
+            && extract ( base, mappedBytes, offset, order32 )
+            && extract ( base, mappedBytes, offset, N64 )
+            && extract ( base, mappedBytes, offset, numKnots )
+            && extract ( base, mappedBytes, offset, rows )
+            && extract ( base, mappedBytes, offset, cols )
+            && extract ( base, mappedBytes, offset, periodic64 )
+            && extract ( base, mappedBytes, offset, dt )
+            && extract ( base, mappedBytes, offset, decimation64 ) ;
+  if ( ok )
+    ok  =  ( offset + numKnots * sizeof(double) + rows * cols * sizeof(int32_t) + N64 * sizeof(double)
+             <= mappedBytes ) ;
+  if ( ! ok )
+    {
+    unmap ( ) ;
+    return ;
+    } // end if
+
+  order       =  order32 ;
+  N           =  N64 ;
+  periodic    =  ( periodic64 != 0 ) ;
+  decimation  =  decimation64 ;
+  knotX.resize ( numKnots ) ;
+  for ( size_t j = 0 ; j < numKnots ; j ++ )
+    extract ( base, mappedBytes, offset, knotX[j] ) ;
+  K_matrix.resize ( rows, cols ) ;
+  for ( size_t r = 0 ; r < rows ; r ++ )
+    for ( size_t p = 0 ; p < cols ; p ++ )
+      {
+      int32_t  k  =  0 ;
+      extract ( base, mappedBytes, offset, k ) ;
+      K_matrix ( r, p )  =  k ;
+      }
+  collocationX.resize ( N ) ;
+  for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+    extract ( base, mappedBytes, offset, collocationX[alpha] ) ;
+
+  headerBytes  =  roundUpTo8 ( offset ) ;
+  frameBytes   =  sizeof(uint64_t) + sizeof(double) + N * sizeof(double) ;
+  // A frame cut short (e.g. by a crash while writing) is not counted.
+  frameCount   =  ( mappedBytes > headerBytes ) ? ( (mappedBytes - headerBytes) / frameBytes ) : 0 ;
+  } // end constructor
+
+// ================================================================================================
+
+// destructor
+TimeSeriesReader::~TimeSeriesReader ( )
+  {
+  unmap ( ) ;
+  } // end destructor
+
+// ================================================================================================
+
+void  TimeSeriesReader::unmap ( )
+  {
+  if ( base == 0 )
+    return ;
+#ifdef _WIN32
+  UnmapViewOfFile ( base ) ;
+  CloseHandle ( static_cast<HANDLE> ( mappingHandle ) ) ;
+#else
+  munmap ( const_cast<char *> ( base ), mappedBytes ) ;
+#endif
+  base        =  0 ;
+  frameCount  =  0 ;
+  } // end unmap
+
+// ================================================================================================
+
+uint64_t  TimeSeriesReader::step ( size_t f ) const
+  {
+  assert ( f < frameCount ) ;
+  uint64_t  value ;
+  std::memcpy ( &value, base + headerBytes + f * frameBytes, sizeof(uint64_t) ) ;
+  return  value ;
+  } // end step
+
+// ================================================================================================
+
+double  TimeSeriesReader::time ( size_t f ) const
+  {
+  assert ( f < frameCount ) ;
+  double  value ;
+  std::memcpy ( &value, base + headerBytes + f * frameBytes + sizeof(uint64_t), sizeof(double) ) ;
+  return  value ;
+  } // end time
+
+// ================================================================================================
+
+Eigen::Map<const Eigen::VectorXd>  TimeSeriesReader::frame ( size_t f ) const
+  {
+  assert ( f < frameCount ) ;
+  const char *  values  =  base + headerBytes + f * frameBytes + sizeof(uint64_t) + sizeof(double) ;
+  return  Eigen::Map<const Eigen::VectorXd> ( reinterpret_cast<const double *> ( values ), N ) ;
+  } // end frame
+
+// ================================================================================================
@@ -0,0 +1,233 @@
+/**
+ * @file    TimeSeries.h
+ * @author  Jeff Solheim <JASolheim@FHSU.edu>
+ * @version  1.0
+ *
+ * @section LICENSE
+ * This program is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @section DESCRIPTION
+ * File TimeSeries.h contains the declarations of the TimeSeriesWriter and
+ * TimeSeriesReader classes, which stream BSCM time steps to and from a binary file.
+ */
+
+#ifndef  TIMESERIES_H
+#define  TIMESERIES_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include <Eigen/Dense>
+#include "Spline.h"
+
+namespace BSCM
+  {
+
+  /**
+   * @brief
+   * Class %TimeSeriesWriter streams the collocation values of successive time steps
+   * to a compact binary file.
+   *
+   * The file begins with a header describing the %Spline
+   * (magic "BSCMTS01", then, as native-endian fields:
+   * uint32 version, uint32 order <b><em>M</em></b>, uint64 <b><em>N</em></b>,
+   * uint64 numKnots, uint64 rows &amp; uint64 columns of <b><em>K_matrix</em></b>,
+   * uint64 periodic flag, double <em>dt</em>, uint64 decimation,
+   * the knots, <b><em>K_matrix</em></b> as int32 in row-major order, and the collocation points,
+   * padded with zeros to a multiple of 8 bytes).\n
+   * Each frame then occupies the same number of bytes:
+   * uint64 step number, double time (= step &times; <em>dt</em>),
+   * and the <b><em>N</em></b> collocation values.\n\n
+   * Frames are gathered into batches; a full batch is handed to a background thread,
+   * which writes it while the time loop fills the other batch.
+   */
+
+  class  TimeSeriesWriter
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Create <em>fileName</em> and write its header
+        *
+        * @param fileName        Output file
+        * @param spline          %Spline whose collocation values are to be written
+        * @param dt              Time step; the time of step <em>n</em> is <em>n</em>&nbsp;&times;&nbsp;<em>dt</em>
+        * @param decimation      Only every <em>decimation</em><sup>&nbsp;th</sup> step is kept
+        * @param framesPerBatch  Number of frames the background thread writes at a time
+        */
+      TimeSeriesWriter ( const std::string & fileName, const Spline & spline, double dt,
+                         size_t decimation = 1, size_t framesPerBatch = 256 ) ;
+
+      /**
+        * @brief
+        * Equivalent to <b><em>close</em></b>
+        */
+      ~TimeSeriesWriter ( ) ;
+
+      /**
+        * @brief
+        * Record the collocation values <em>u</em> of time step <em>step</em>
+        *
+        * Steps that are not multiples of the decimation are ignored.
+        * Returns without waiting unless both batches are full.
+        */
+      void  write ( uint64_t step, const Eigen::VectorXd & u ) ;
+
+      /**
+        * @brief
+        * Write any remaining frames and close the file
+        */
+      void  close ( ) ;
+
+      /**
+        * @brief
+        * false once any write to the file has failed
+        */
+      bool  good ( ) const ;
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      TimeSeriesWriter ( const TimeSeriesWriter & ) ;              // not copyable
+      TimeSeriesWriter &  operator= ( const TimeSeriesWriter & ) ; // not assignable
+
+      std::FILE *  file ;
+      size_t       N ;
+      double       dt ;
+      size_t       decimation ;
+      size_t       framesPerBatch ;
+      size_t       frameBytes ;
+
+      /**
+        * The batch being filled by <b><em>write</em></b>, and the batch being written to the file.
+        */
+      std::vector<char>  fillBatch ;
+      std::vector<char>  flushBatch ;
+      size_t             fillFrames ;
+      size_t             flushFrames ;
+
+      /**
+        * Guards flushBatch, flushFrames, flushPending, closing &amp; failed.
+        */
+      mutable std::mutex       batchMutex ;
+      std::condition_variable  batchChanged ;
+      bool                     flushPending ;
+      bool                     closing ;
+      bool                     failed ;
+      std::thread              flusher ;
+
+      /**
+        * Wait until flushBatch is free, then swap it with fillBatch for the background thread.
+        */
+      void  handOff ( ) ;
+
+      /**
+        * Body of the background thread.
+        */
+      void  flushLoop ( ) ;
+
+    } ; // end TimeSeriesWriter class
+
+  /**
+   * @brief
+   * Class %TimeSeriesReader gives random access to the frames of a file
+   * written by TimeSeriesWriter.
+   *
+   * The file is memory-mapped, so a frame is read directly from the page cache
+   * without copying.
+   */
+
+  class  TimeSeriesReader
+    {
+
+    public :  //  ----------------------------------  Member Functions  ------------------------------------------
+
+      /**
+        * @brief
+        * Map <em>fileName</em> into memory and read its header
+        *
+        * If the file cannot be mapped or is not a BSCM time series,
+        * <b><em>good</em></b> returns false and there are no frames.
+        */
+      explicit TimeSeriesReader ( const std::string & fileName ) ;
+
+      /**
+        * @brief
+        * Unmap the file
+        */
+      ~TimeSeriesReader ( ) ;
+
+      /** @brief true if the file was mapped and its header is valid */
+      bool  good ( ) const  { return  base != 0 ; }
+
+      /** @brief Number of complete frames in the file */
+      size_t  numFrames ( ) const  { return  frameCount ; }
+
+      /** @brief Step number of frame <em>f</em> */
+      uint64_t  step ( size_t f ) const ;
+
+      /** @brief Time of frame <em>f</em> */
+      double  time ( size_t f ) const ;
+
+      /** @brief Collocation values of frame <em>f</em>, read in place from the mapped file */
+      Eigen::Map<const Eigen::VectorXd>  frame ( size_t f ) const ;
+
+      /** @brief %Spline order <b><em>M</em></b> */
+      size_t  getOrder ( ) const  { return  order ; }
+
+      /** @brief Number of collocation points <b><em>N</em></b> */
+      size_t  getN ( ) const  { return  N ; }
+
+      /** @brief Sequence of knot points */
+      const std::vector<double> &  getKnotX ( ) const  { return  knotX ; }
+
+      /** @brief Sequence of collocation points */
+      const std::vector<double> &  getCollocationX ( ) const  { return  collocationX ; }
+
+      /** @brief Boundary conditions (empty for a periodic %Spline) */
+      const Eigen::MatrixXi &  getK_matrix ( ) const  { return  K_matrix ; }
+
+      /** @brief Whether the %Spline was periodic */
+      bool  isPeriodic ( ) const  { return  periodic ; }
+
+      /** @brief Time step */
+      double  getDt ( ) const  { return  dt ; }
+
+      /** @brief Decimation with which the frames were written */
+      size_t  getDecimation ( ) const  { return  decimation ; }
+
+    private :  //  -----------------------------------------------------------------------------------------------
+
+      TimeSeriesReader ( const TimeSeriesReader & ) ;              // not copyable
+      TimeSeriesReader &  operator= ( const TimeSeriesReader & ) ; // not assignable
+
+      const char *  base ;        //  start of the mapping, or 0
+      size_t        mappedBytes ;
+      void *        mappingHandle ;  //  used only on Windows
+
+      size_t  order ;
+      size_t  N ;
+      bool    periodic ;
+      double  dt ;
+      size_t  decimation ;
+      std::vector<double>  knotX ;
+      std::vector<double>  collocationX ;
+      Eigen::MatrixXi      K_matrix ;
+
+      size_t  headerBytes ;
+      size_t  frameBytes ;
+      size_t  frameCount ;
+
+      void  unmap ( ) ;
+
+    } ; // end TimeSeriesReader class
+
+  } // end namespace BSCM
+
+#endif  //  TIMESERIES_H
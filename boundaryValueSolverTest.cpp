@@ -0,0 +1,83 @@
+/*
+  boundaryValueSolverTest.cpp    Jeffery Solheim
+  Checks that BSCM::BoundaryValueSolver reports a singular operator as singular.
+
+  Usage:   boundaryValueSolverTest
+
+  For orders 3, 5 & 7, the Poisson operator d^2/dx^2 is factored on uniform knots under
+  three sets of boundary conditions.  With Neumann conditions at both ends the constants
+  solve the homogeneous problem, so good() must be false; with Dirichlet conditions at
+  either end, or with a shift added to the Neumann operator, good() must be true and
+  solve must reproduce random right-hand sides.
+
+  Exit status is 0 if every check passes, and 1 otherwise.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "BoundaryValueSolver.h"
+
+using namespace std ;
+
+// ================================================================================================
+
+static bool  check ( bool passed, const string & what )
+  {
+  cout << ( passed ? "pass  " : "FAIL  " ) << what << endl ;
+  return  passed ;
+  } // end check
+
+// ================================================================================================
+
+// Rows for each boundary force derivatives 0, 2, 4, ... (D) or 1, 3, 5, ... (N) to be zero.
+static Eigen::MatrixXi  boundaryConditions ( size_t order, const string & bc )
+  {
+  size_t  rowsPerSide  =  ( order - 1 ) / 2 ;
+  Eigen::MatrixXi  K  =  Eigen::MatrixXi::Zero ( order - 1, order ) ;
+  for ( size_t r = 0 ; r < rowsPerSide ; r ++ )
+    {
+    K ( r,               2*r + ((bc[0] == 'N') ? 1 : 0) )  =  1 ;
+    K ( rowsPerSide + r, 2*r + ((bc[1] == 'N') ? 1 : 0) )  =  1 ;
+    } // end for r loop
+  return  K ;
+  } // end boundaryConditions
+
+// ================================================================================================
+
+int main ( )
+  {
+  const size_t  orders []  =  { 3, 5, 7 } ;
+  const size_t  Ns []      =  { 16, 400 } ;
+  bool  passed  =  true ;
+  for ( size_t o = 0 ; o < 3 ; o ++ )
+    for ( size_t n = 0 ; n < 2 ; n ++ )
+      {
+      const size_t  order  =  orders[o], N  =  Ns[n] ;
+      vector<double>  knotX ;
+      for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+        knotX.push_back ( ( static_cast<double>(j) - static_cast<double>(order - 1) ) / N ) ;
+      Eigen::VectorXd  rho  =  Eigen::VectorXd::Random ( N ) ;
+      ostringstream  name ;
+      name << "M = " << order << ", N = " << N << ":  " ;
+
+      BSCM::BoundaryValueSolver  neumann ( BSCM::Spline::create ( order, knotX, boundaryConditions(order,"NN") ), 2 ) ;
+      passed  =  check ( ! neumann.good(), name.str() + "NN Poisson operator is singular" ) && passed ;
+
+      const char *  nonsingular []  =  { "DD", "ND" } ;
+      for ( size_t b = 0 ; b < 2 ; b ++ )
+        {
+        BSCM::BoundaryValueSolver  solver ( BSCM::Spline::create ( order, knotX, boundaryConditions(order,nonsingular[b]) ), 2 ) ;
+        bool  solved  =  solver.good()
+                         && ( (solver.apply(solver.solve(rho)) - rho).norm() <= 1.0e-8 * rho.norm() ) ;
+        passed  =  check ( solved, name.str() + nonsingular[b] + " Poisson operator is solved" ) && passed ;
+        } // end for b loop
+
+      BSCM::BoundaryValueSolver  shifted ( BSCM::Spline::create ( order, knotX, boundaryConditions(order,"NN") ),
+                                           2, -1.0, 1.0 ) ;
+      bool  solved  =  shifted.good()
+                       && ( (shifted.apply(shifted.solve(rho)) - rho).norm() <= 1.0e-8 * rho.norm() ) ;
+      passed  =  check ( solved, name.str() + "NN operator with a shift is solved" ) && passed ;
+      } // end for n loop
+  return  passed ? 0 : 1 ;
+  } // end main
@@ -0,0 +1,96 @@
+/*
+  domainDecompositionTest.cpp    Jeffery Solheim
+  Compares BSCM::DomainDecomposition with a solve on one Spline over the whole lattice.
+
+  Usage:   domainDecompositionTest
+
+  For orders 3, 5 & 7, and 1, 4 & 8 subdomains, the implicit heat step
+  (sigma - kappa d^2/dx^2) u = f is solved on 200 uniform knot intervals with Dirichlet
+  conditions, both by DomainDecomposition and by LU factors of the same operator
+  built on one Spline; the two must agree to near rounding.  Before solving, the test also
+  starts a child process of its own, which solve must leave for the test to reap.
+
+  Exit status is 0 if every check passes, and 1 otherwise.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+#include "DomainDecomposition.h"
+
+#ifndef _WIN32
+  #include <unistd.h>
+  #include <sys/wait.h>
+#endif
+
+using namespace std ;
+
+// ================================================================================================
+
+static bool  check ( bool passed, const string & what )
+  {
+  cout << ( passed ? "pass  " : "FAIL  " ) << what << endl ;
+  return  passed ;
+  } // end check
+
+// ================================================================================================
+
+int main ( )
+  {
+  const size_t  N  =  200, overlap  =  6 ;
+  const double  xMin  =  0.0, xMax  =  1.0, shift  =  10.0, diffusivity  =  1.0 ;
+  const size_t  orders []         =  { 3, 5, 7 } ;
+  const size_t  numSubdomains []  =  { 1, 4, 8 } ;
+  bool  passed  =  true ;
+
+#ifndef _WIN32
+  // A child which is none of solve's business; it exits at once, with a status of its own.
+  pid_t  bystander  =  fork ( ) ;
+  if ( bystander == 0 )
+    _exit ( 7 ) ;
+#endif
+
+  for ( size_t o = 0 ; o < 3 ; o ++ )
+    {
+    const size_t  order  =  orders[o] ;
+    Eigen::MatrixXi  K  =  Eigen::MatrixXi::Zero ( order - 1, order ) ;
+    for ( size_t r = 0 ; r < (order - 1) / 2 ; r ++ )
+      {
+      K ( r,                   2*r )  =  1 ;
+      K ( (order - 1)/2 + r,   2*r )  =  1 ;
+      } // end for r loop
+
+    // The reference:  one Spline on the global knots, and the dense operator.
+    vector<double>  knotX ;
+    for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+      knotX.push_back ( xMin + ( static_cast<double>(j) - static_cast<double>(order - 1) ) * (xMax - xMin) / N ) ;
+    BSCM::Spline     spline ( order, knotX, K ) ;
+    Eigen::MatrixXd  A  =  - diffusivity * spline.operatorMatrix ( 2 ) ;
+    A.diagonal().array()  +=  shift ;
+    Eigen::VectorXd  f ( N ) ;
+    for ( size_t alpha = 0 ; alpha < N ; alpha ++ )
+      f ( alpha )  =  sin ( 3.0 * spline.getCollocationX()[alpha] ) + 1.0 ;
+    Eigen::VectorXd  reference  =  A.partialPivLu().solve ( f ) ;
+
+    for ( size_t d = 0 ; d < 3 ; d ++ )
+      {
+      BSCM::DomainDecomposition  dd ( order, xMin, xMax, N, K, numSubdomains[d], overlap ) ;
+      Eigen::VectorXd  u  =  dd.solve ( f, shift, diffusivity, 1.0e-14, 2000 ) ;
+      double  difference  =  ( u - reference ).cwiseAbs().maxCoeff() / reference.cwiseAbs().maxCoeff() ;
+      ostringstream  what ;
+      what << "M = " << order << ", " << numSubdomains[d] << " subdomain(s):  converged in "
+           << dd.iterations() << " iterations, difference " << difference ;
+      passed  =  check ( dd.converged() && (difference < 1.0e-11), what.str() ) && passed ;
+      } // end for d loop
+    } // end for o loop
+
+#ifndef _WIN32
+  int  status  =  0 ;
+  passed  =  check ( (bystander > 0) && (waitpid ( bystander, &status, 0 ) == bystander)
+                     && WIFEXITED(status) && (WEXITSTATUS(status) == 7),
+                     "solve leaves the caller's other children alone" ) && passed ;
+#endif
+
+  return  passed ? 0 : 1 ;
+  } // end main
@@ -0,0 +1,95 @@
+/*
+  fastDiagonalizationTest.cpp    Jeffery Solheim
+  Compares BSCM::FastDiagonalization with the dense operator of a two-dimensional lattice.
+
+  Usage:   fastDiagonalizationTest
+
+  Two lattices are tried:  one whose axes both diagonalize, and one with an axis of order 9
+  whose eigenvector basis is too ill-conditioned to use (derivatives 0 to 3 fixed at the
+  left boundary and 4 to 7 at the right), which must fall back on its Schur form.  On each,
+  solve must have a backward error near rounding, and propagate must agree with the
+  exponential of the dense Laplacian (the Kronecker sum of the axis operators).
+
+  Exit status is 0 if every check passes, and 1 otherwise.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <unsupported/Eigen/KroneckerProduct>
+#include <unsupported/Eigen/MatrixFunctions>
+#include "FastDiagonalization.h"
+
+using namespace std ;
+
+// ================================================================================================
+
+static bool  check ( bool passed, const string & what )
+  {
+  cout << ( passed ? "pass  " : "FAIL  " ) << what << endl ;
+  return  passed ;
+  } // end check
+
+// ================================================================================================
+
+// Uniform knots, with (order - 1) knots beyond each physical boundary.
+static vector<double>  uniformKnots ( size_t order, size_t N, double xMin, double xMax )
+  {
+  vector<double>  knotX ;
+  double  h  =  ( xMax - xMin ) / N ;
+  for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+    knotX.push_back ( xMin + ( static_cast<double>(j) - static_cast<double>(order - 1) ) * h ) ;
+  return  knotX ;
+  } // end uniformKnots
+
+// ================================================================================================
+
+static bool  compare ( const vector<BSCM::SplinePtr> & splines, bool expectDiagonalized, const string & name )
+  {
+  const double  scale  =  2.0, shift  =  3.0, t  =  1.0e-3, diffusivity  =  0.7 ;
+  BSCM::FastDiagonalization  fd ( splines, 2 ) ;
+  size_t  n0  =  splines[0]->getN(), n1  =  splines[1]->getN() ;
+  Eigen::MatrixXd  L  =  Eigen::kroneckerProduct ( Eigen::MatrixXd::Identity(n1,n1), splines[0]->operatorMatrix(2) )
+                       + Eigen::kroneckerProduct ( splines[1]->operatorMatrix(2), Eigen::MatrixXd::Identity(n0,n0) ) ;
+  Eigen::MatrixXd  A  =  scale * L ;
+  A.diagonal().array()  +=  shift ;
+
+  Eigen::VectorXd  rho  =  Eigen::VectorXd::Random ( n0 * n1 ) ;
+  Eigen::VectorXd  u    =  fd.solve ( rho, scale, shift ) ;
+  double  backwardError  =  ( A * u - rho ).norm() / ( A.norm() * u.norm() ) ;
+
+  Eigen::VectorXd  u0     =  u / u.norm() ;
+  Eigen::VectorXd  exact  =  ( (diffusivity * t) * L ).exp() * u0 ;
+  double  heatError  =  ( fd.propagate ( u0, t, diffusivity ) - exact ).norm() / exact.norm() ;
+
+  ostringstream  what ;
+  what << name << ":  isDiagonalized " << fd.isDiagonalized() << ", solve backward error " << backwardError
+       << ", propagate error " << heatError ;
+  return  check ( (fd.isDiagonalized() == expectDiagonalized) && (backwardError < 1.0e-14) && (heatError < 1.0e-6),
+                  what.str() ) ;
+  } // end compare
+
+// ================================================================================================
+
+int main ( )
+  {
+  Eigen::MatrixXi  K_dirichlet ( 4, 5 ), K_clamped  =  Eigen::MatrixXi::Zero ( 8, 9 ) ;
+  K_dirichlet  <<  1, 0, 0, 0, 0,
+                   0, 0, 1, 0, 0,
+                   1, 0, 0, 0, 0,
+                   0, 0, 1, 0, 0 ;
+  for ( size_t r = 0 ; r < 4 ; r ++ )
+    {
+    K_clamped ( r,     r )      =  1 ;
+    K_clamped ( 4 + r, 4 + r )  =  1 ;
+    } // end for r loop
+  BSCM::SplinePtr  good  =  BSCM::Spline::create ( 5, uniformKnots ( 5, 12, 0.0, 2.0 ), K_dirichlet ) ;
+  BSCM::SplinePtr  other =  BSCM::Spline::create ( 5, uniformKnots ( 5, 20, 0.0, 1.0 ), K_dirichlet ) ;
+  BSCM::SplinePtr  bad   =  BSCM::Spline::create ( 9, uniformKnots ( 9, 64, 0.0, 1.0 ), K_clamped ) ;
+
+  bool  passed  =  true ;
+  passed  =  compare ( vector<BSCM::SplinePtr> { other, good }, true,  "diagonalized axes" ) && passed ;
+  passed  =  compare ( vector<BSCM::SplinePtr> { bad, good },   false, "Schur axis first " ) && passed ;
+  passed  =  compare ( vector<BSCM::SplinePtr> { good, bad },   false, "Schur axis second" ) && passed ;
+  return  passed ? 0 : 1 ;
+  } // end main
@@ -16,8 +16,10 @@ Author: Jeff Solheim   Date: 03 JAN 2013
 
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include "Spline.h"
-#include <unsupported/Eigen/MatrixFunctions>
+#include "TimeSeries.h"
+#include "KrylovPropagator.h"
 
 using namespace std ;
 
@@ -37,43 +39,57 @@ int main ( int argc, char *argv[] )
   //                      1, 0, 0, 0, 0,
   //                      0, 1, 0, 0, 0 ;
   // instantiate the Spline class ...
-  BSCM::Spline     testSpline ( splineOrder, knotVector, boundaryConditionsMatrix ) ;
+  BSCM::SplinePtr  splinePtr  =  BSCM::Spline::create ( splineOrder, knotVector, boundaryConditionsMatrix ) ;
+  const BSCM::Spline &  testSpline  =  *splinePtr ;
   // obtain the matrix representation of the second derivative ...
   Eigen::MatrixXd  D  =  testSpline.operatorMatrix ( 2 ) ;
   double thermalDiffusivity  =  0.5 ;
-  Eigen::MatrixXd  A  =  (thermalDiffusivity * testSpline.operatorMatrix(2)).exp() ;
   Eigen::VectorXd  u ;
-  u.resize ( testSpline.numKnots - 2 * testSpline.order + 1 ) ; // 8 - 2*3 + 1 = 3
+  u.resize ( testSpline.getNumKnots() - 2 * testSpline.getOrder() + 1 ) ; // 8 - 2*3 + 1 = 3
   u << 1, 0, 0.5 ; // initial temperatures at collocation points
+  // the propagator applies exp(thermalDiffusivity * D) to u without forming the exponential ...
+  BSCM::KrylovPropagator  propagator  =  BSCM::KrylovPropagator::heat ( splinePtr, thermalDiffusivity ) ;
+  // given a file name, stream the time steps to that file rather than printing them ...
+  std::unique_ptr<BSCM::TimeSeriesWriter>  series ;
+  if ( argc > 1 )
+    {
+    series.reset ( new BSCM::TimeSeriesWriter ( argv[1], testSpline, 1.0 ) ) ;
+    series->write ( 0, u ) ;
+    }
   // iterate through several time periods to simulate diffusion of heat within rod ...
   for ( int t = 1 ; t <= 5 ; t++ )
     {
-    u = A * u ;
-	cout << u << endl << endl ;
+    u  =  propagator.apply ( u, 1.0 ) ;
+    if ( series )
+      series->write ( t, u ) ;
+    else
+	  cout << u << endl << endl ;
     }
+  if ( series )
+    series->close ( ) ;
 
 exit(0);
 
   cout << "=====================================================================\n" ;
   cout << "Collocation points collocationX.at(i) ..." ;
-  for ( unsigned int i = 0 ; i < testSpline.collocationX.size() ; i ++ )
-   cout << testSpline.collocationX.at(i) << endl ;
+  for ( unsigned int i = 0 ; i < testSpline.getCollocationX().size() ; i ++ )
+   cout << testSpline.getCollocationX().at(i) << endl ;
 
   cout << "=====================================================================\n" ;
   cout << "B(k,i,x) = ..." ;
-  for ( size_t k = 1 ; k <= testSpline.order ; k ++ )
-    for ( size_t i = 0 ; i < (testSpline.knotX.size() - k - 1) ; i ++ )
+  for ( size_t k = 1 ; k <= testSpline.getOrder() ; k ++ )
+    for ( size_t i = 0 ; i < (testSpline.getKnotX().size() - k - 1) ; i ++ )
       for ( double x = 1.41 ; x <= 6.99 ; x += 0.40 )
         cout << "B(" << k << "," << i << "," << x << ") \t" << testSpline.B(k,i,x) << endl ;
 
   cout << "=====================================================================\n" ;
   cout << "B(k,i,alpha) = ..." ;
-  for ( size_t k = 1 ; k <= testSpline.order ; k ++ )
-    for ( size_t i = 0 ; i < (testSpline.knotX.size() - k - 1) ; i ++ )
+  for ( size_t k = 1 ; k <= testSpline.getOrder() ; k ++ )
+    for ( size_t i = 0 ; i < (testSpline.getKnotX().size() - k - 1) ; i ++ )
       {
-      for ( size_t alpha = 0 ; alpha < testSpline.collocationX.size() ; alpha ++ )
+      for ( size_t alpha = 0 ; alpha < testSpline.getCollocationX().size() ; alpha ++ )
         {
-        cout << "B(" << k << "," << i << "," << alpha << ") [" << testSpline.collocationX.at(alpha) << "] \t"
+        cout << "B(" << k << "," << i << "," << alpha << ") [" << testSpline.getCollocationX().at(alpha) << "] \t"
              << testSpline.B(k,i,alpha) << endl ;
         }
       cout << "--------------------------" << endl ;
@@ -81,10 +97,10 @@ exit(0);
 
   cout << "=====================================================================\n" ;
   cout << "D_B(p,k,i,x) = ..." ;
-  for ( size_t p = 0 ; p < testSpline.order ; p ++ )
+  for ( size_t p = 0 ; p < testSpline.getOrder() ; p ++ )
     {
-    for ( size_t k = (p+1) ; k <= testSpline.order ; k ++ )
-      for ( size_t i = 0 ; i < (testSpline.knotX.size() - k - 1) ; i ++ )
+    for ( size_t k = (p+1) ; k <= testSpline.getOrder() ; k ++ )
+      for ( size_t i = 0 ; i < (testSpline.getKnotX().size() - k - 1) ; i ++ )
         for ( double x = 1.41 ; x <= 6.99 ; x += 0.40 )
           cout << "D_B(" << p << "," << k << "," << i << "," << x << ") \t"
                << testSpline.D_B(p,k,i,x) << endl ;
@@ -93,23 +109,23 @@ exit(0);
 
   std::cout << std::setprecision(2) << setw(6) ;
   cout << "=====================================================================\n" ;
-  cout << "B_matrix is\n" << testSpline.B_matrix << endl ;
+  cout << "B_matrix is\n" << testSpline.getB_matrix() << endl ;
 
   cout << "=====================================================================\n" ;
-  cout << "K_matrix is\n" << testSpline.K_matrix << endl ;
+  cout << "K_matrix is\n" << testSpline.getK_matrix() << endl ;
 
   cout << "=====================================================================\n" ;
-  cout << "beta_matrix is\n" << testSpline.beta_matrix << endl ;
+  cout << "beta_matrix is\n" << testSpline.getBeta_matrix() << endl ;
 
   cout << "=====================================================================\n" ;
   cout << "test value D_B == "
-       << testSpline.D_B ( testSpline.order-1, testSpline.order, 8, 10.0 ) << endl ;
+       << testSpline.D_B ( testSpline.getOrder()-1, testSpline.getOrder(), 8, 10.0 ) << endl ;
 // failed:  assert ( i < (knotX.size() - k) ) ;  //  i can range 0 to # of knots - k
 
 
   cout << "=====================================================================\n" ;
   for ( double x = 1.0 ; x <= 8.0 ; x +=0.5 )
-    cout << x << "\t" << testSpline.D_B ( 2, testSpline.order, 1, x ) << endl ;
+    cout << x << "\t" << testSpline.D_B ( 2, testSpline.getOrder(), 1, x ) << endl ;
   // Maple equivalent is `&Delta;B`(2, M, 2, x)
 
   cout << "=====================================================================\n" ;
@@ -117,13 +133,13 @@ exit(0);
 
   cout << "=====================================================================\n" ;
 
-for ( size_t k = 1 ; k <= testSpline.order ; k ++ )
+for ( size_t k = 1 ; k <= testSpline.getOrder() ; k ++ )
   {
-  for ( size_t i = 0 ; i <= (testSpline.N + 2*testSpline.order - k - 2) ; i ++ )
+  for ( size_t i = 0 ; i <= (testSpline.getN() + 2*testSpline.getOrder() - k - 2) ; i ++ )
     {
-    for ( size_t alpha = 0 ; alpha <= (testSpline.N - 1) ; alpha ++ )
+    for ( size_t alpha = 0 ; alpha <= (testSpline.getN() - 1) ; alpha ++ )
       {
-      double  a  =  testSpline.B ( k, i, testSpline.collocationX[alpha] ) ;
+      double  a  =  testSpline.B ( k, i, testSpline.getCollocationX()[alpha] ) ;
       double  b  =  testSpline.B ( k, i, alpha ) ;
       //double  b  =  testSpline.B_k_i_alpha.at(k).at(i).at(alpha) ;
       double  c  =  a - b ;
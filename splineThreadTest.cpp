@@ -0,0 +1,120 @@
+/*
+  splineThreadTest.cpp    Jeffery Solheim
+  Exercises one shared BSCM::Spline from many threads at once.
+
+  Usage:   splineThreadTest
+
+  Eight threads, released together, use one SplinePtr (and one periodic SplinePtr):
+  each fills and reads the operator cache (cachedOperatorMatrix), derives new Splines from
+  the shared one while the cache is being filled (updateBoundaryConditions, mapAffinely),
+  and calls operatorMatrix, applyOperator, B, D_B, coefficients, evaluate and solvePeriodic.
+  Every thread's results must equal those computed beforehand on one thread.
+
+  Meant to be built with ThreadSanitizer, which then reports any data race, e.g.
+      g++ -std=c++11 -O1 -g -fsanitize=thread -pthread splineThreadTest.cpp Spline.cpp
+          CollocationStrategy.cpp -o splineThreadTest -I<Eigen>
+  (MinGW has no ThreadSanitizer; Build.bat builds the plain program, which still checks the results.)
+
+  Exit status is 0 if every check passes, and 1 otherwise.
+*/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "Spline.h"
+
+using namespace std ;
+
+// ================================================================================================
+
+// Everything one thread computes from the shared Splines.
+struct  Results
+  {
+  vector<Eigen::MatrixXd>  cached ;
+  vector<Eigen::MatrixXd>  computed ;
+  vector<Eigen::VectorXd>  applied ;
+  Eigen::MatrixXd          updated ;
+  Eigen::MatrixXd          mapped ;
+  double                   basis ;
+  double                   value ;
+  Eigen::VectorXd          periodic ;
+  } ;
+
+static Results  compute ( const BSCM::SplinePtr & spline, const BSCM::SplinePtr & ring,
+                          const Eigen::MatrixXi & K_other, const Eigen::VectorXd & u )
+  {
+  Results  r ;
+  for ( size_t p = 1 ; p < spline->getOrder() ; p ++ )
+    {
+    r.cached.push_back   ( spline->cachedOperatorMatrix ( p ) ) ;
+    r.computed.push_back ( spline->operatorMatrix ( p ) ) ;
+    r.applied.push_back  ( spline->applyOperator ( p, u ) ) ;
+    } // end for p loop
+  r.updated  =  spline->updateBoundaryConditions ( K_other )->cachedOperatorMatrix ( 2 ) ;
+  r.mapped   =  spline->mapAffinely ( 1.0, 2.0 )->cachedOperatorMatrix ( 2 ) ;
+  r.basis    =  spline->B ( spline->getOrder(), 3, size_t(5) ) + spline->D_B ( 2, spline->getOrder(), 3, 0.3 ) ;
+  r.value    =  spline->evaluate ( spline->coefficients ( u ), 1, 0.4 ) ;
+  r.periodic =  ring->solvePeriodic ( 2, ring->applyOperator ( 2, u ), 1.0 ) ;
+  return  r ;
+  } // end compute
+
+// ================================================================================================
+
+static bool  same ( const Results & a, const Results & b )
+  {
+  bool  equal  =  ( a.basis == b.basis ) && ( a.value == b.value ) && ( a.periodic == b.periodic )
+                  && ( a.updated == b.updated ) && ( a.mapped == b.mapped ) ;
+  for ( size_t p = 0 ; p < a.cached.size() ; p ++ )
+    equal  =  equal && ( a.cached[p] == b.cached[p] ) && ( a.computed[p] == b.computed[p] )
+                    && ( a.applied[p] == b.applied[p] ) ;
+  return  equal ;
+  } // end same
+
+// ================================================================================================
+
+int main ( )
+  {
+  const size_t  order  =  5, N  =  40 ;
+  vector<double>  knotX ;
+  for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+    knotX.push_back ( ( static_cast<double>(j) - static_cast<double>(order - 1) ) / N ) ;
+  Eigen::MatrixXi  K ( 4, 5 ), K_other ( 4, 5 ) ;
+  K        <<  1, 0, 0, 0, 0,
+               0, 0, 1, 0, 0,
+               1, 0, 0, 0, 0,
+               0, 0, 1, 0, 0 ;
+  K_other  <<  0, 1, 0, 0, 0,
+               0, 0, 0, 1, 0,
+               0, 1, 0, 0, 0,
+               0, 0, 0, 1, 0 ;
+  Eigen::VectorXd  u  =  Eigen::VectorXd::LinSpaced ( N, 0.0, 1.0 ).array().sin() ;
+
+  // The reference, from Splines of their own.
+  Results  reference  =  compute ( BSCM::Spline::create ( order, knotX, K ),
+                                   BSCM::Spline::create ( order, 0.0, 1.0, N ), K_other, u ) ;
+
+  // Fresh shared Splines, so that the threads race to fill their caches.
+  BSCM::SplinePtr  spline  =  BSCM::Spline::create ( order, knotX, K ) ;
+  BSCM::SplinePtr  ring    =  BSCM::Spline::create ( order, 0.0, 1.0, N ) ;
+  const size_t     numThreads  =  8 ;
+  vector<Results>  results ( numThreads ) ;
+  atomic<size_t>   ready ( 0 ) ;
+  vector<thread>   threads ;
+  for ( size_t t = 0 ; t < numThreads ; t ++ )
+    threads.push_back ( thread ( [&, t] ( )
+      {
+      ready ++ ;
+      while ( ready.load() < numThreads )
+        this_thread::yield ( ) ;
+      results[t]  =  compute ( spline, ring, K_other, u ) ;
+      } ) ) ;
+  for ( size_t t = 0 ; t < numThreads ; t ++ )
+    threads[t].join ( ) ;
+
+  bool  passed  =  true ;
+  for ( size_t t = 0 ; t < numThreads ; t ++ )
+    passed  =  passed && same ( results[t], reference ) ;
+  cout << ( passed ? "pass  " : "FAIL  " ) << "every thread agrees with the single-threaded results" << endl ;
+  return  passed ? 0 : 1 ;
+  } // end main
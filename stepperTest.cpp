@@ -0,0 +1,150 @@
+/*
+  stepperTest.cpp    Jeffery Solheim
+  Counts heap allocations made by BSCM::Stepper::step, which must make none.
+
+  Usage:   stepperTest
+
+  The global operator new (and, with the GNU C library, malloc, through which Eigen allocates)
+  is replaced by one which counts its calls.  A Stepper (with and
+  without boundary forcing) is built, and then stepped; the count must not change while
+  stepping, whether one Stepper runs alone or several run concurrently on one shared
+  propagator.  When compiled with EIGEN_RUNTIME_NO_MALLOC defined, Eigen's malloc permission
+  (one flag for the whole process) is also withdrawn around the single-threaded steps, so that
+  Eigen asserts should any allocation slip past the counter.
+
+  Exit status is 0 if every check passes, and 1 otherwise.
+*/
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include "Spline.h"
+#include "Stepper.h"
+
+using namespace std ;
+
+// ================================================================================================
+
+static atomic<size_t>  allocations ( 0 ) ;
+
+void *  operator new ( size_t size )
+  {
+  allocations ++ ;
+  void *  p  =  malloc ( size ? size : 1 ) ;
+  if ( p == 0 )
+    throw  bad_alloc ( ) ;
+  return  p ;
+  } // end operator new
+
+void *  operator new[] ( size_t size )
+  {
+  return  operator new ( size ) ;
+  } // end operator new[]
+
+void  operator delete ( void * p ) noexcept
+  {
+  free ( p ) ;
+  } // end operator delete
+
+void  operator delete[] ( void * p ) noexcept
+  {
+  free ( p ) ;
+  } // end operator delete[]
+
+// Eigen allocates through malloc rather than new; count those too, where the C library allows.
+#if defined(__GLIBC__)
+extern "C" void *  __libc_malloc ( size_t size ) ;
+extern "C" void *  malloc ( size_t size )
+  {
+  allocations ++ ;
+  return  __libc_malloc ( size ) ;
+  } // end malloc
+#endif
+
+// ================================================================================================
+
+static bool  check ( bool passed, const char * what )
+  {
+  cout << ( passed ? "pass  " : "FAIL  " ) << what << endl ;
+  return  passed ;
+  } // end check
+
+// ================================================================================================
+
+int main ( )
+  {
+  const size_t  order  =  5, N  =  60 ;
+  vector<double>  knotX ;
+  for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+    knotX.push_back ( ( static_cast<double>(j) - static_cast<double>(order - 1) ) / N ) ;
+  Eigen::MatrixXi  K ( 4, 5 ) ;
+  K  <<  1, 0, 0, 0, 0,
+         0, 0, 1, 0, 0,
+         1, 0, 0, 0, 0,
+         0, 0, 1, 0, 0 ;
+  BSCM::SplinePtr  spline  =  BSCM::Spline::create ( order, knotX, K ) ;
+
+  shared_ptr<const Eigen::MatrixXd>  P  =  BSCM::Stepper::heatPropagator ( *spline, 1.0, 1.0e-4 ) ;
+  shared_ptr<const Eigen::MatrixXd>  G  =  BSCM::Stepper::heatForcing    ( *spline, 1.0, 1.0e-4 ) ;
+  Eigen::VectorXd  u0  =  Eigen::VectorXd::Ones ( N ) ;
+  Eigen::VectorXd  g   =  Eigen::VectorXd::Constant ( order - 1, 0.5 ) ;
+  bool  passed  =  true ;
+
+  // The counter must see an Eigen temporary, or the checks below prove nothing.  Elsewhere
+  // only operator new is counted, and Eigen's own assertions (EIGEN_RUNTIME_NO_MALLOC) must
+  // catch its allocations.
+  size_t  before  =  allocations.load ( ) ;
+#if defined(__GLIBC__)
+  Eigen::VectorXd  product  =  (*P) * u0 ;
+  passed  =  check ( allocations.load() > before, "allocations are counted" ) && passed ;
+#endif
+
+  // One Stepper alone.
+  BSCM::Stepper  plain ( P, u0 ) ;
+  BSCM::Stepper  forced ( P, G, u0 ) ;
+  before  =  allocations.load ( ) ;
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+  Eigen::internal::set_is_malloc_allowed ( false ) ;
+#endif
+  plain.step ( 1000 ) ;
+  for ( int s = 0 ; s < 1000 ; s ++ )
+    forced.step ( g ) ;
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+  passed  =  check ( ! Eigen::internal::is_malloc_allowed(), "step leaves the malloc permission alone" ) && passed ;
+  Eigen::internal::set_is_malloc_allowed ( true ) ;
+#endif
+  passed  =  check ( allocations.load() == before, "no allocation while stepping" ) && passed ;
+
+  // Several Steppers sharing one propagator, each on its own thread; only the counter watches
+  // these, since Eigen's malloc permission is not safe to change from several threads.
+  const size_t  numThreads  =  4 ;
+  vector<BSCM::Stepper>  steppers ( numThreads, BSCM::Stepper ( P, u0 ) ) ;
+  atomic<size_t>         ready ( 0 ), finished ( 0 ) ;
+  atomic<bool>           go ( false ) ;
+  vector<thread>         threads ;
+  for ( size_t t = 0 ; t < numThreads ; t ++ )
+    threads.push_back ( thread ( [&, t] ( )
+      {
+      ready ++ ;
+      while ( ! go.load ( ) )
+        this_thread::yield ( ) ;
+      steppers[t].step ( 1000 ) ;
+      finished ++ ;
+      } ) ) ;
+  while ( ready.load() < numThreads )
+    this_thread::yield ( ) ;
+  before  =  allocations.load ( ) ;
+  go.store ( true ) ;
+  while ( finished.load() < numThreads )  //  spin, allocating nothing, until every thread is done
+    this_thread::yield ( ) ;
+  passed  =  check ( allocations.load() == before, "no allocation while stepping concurrently" ) && passed ;
+  for ( size_t t = 0 ; t < numThreads ; t ++ )
+    threads[t].join ( ) ;
+  passed  =  check ( (steppers[0].state() - plain.state()).cwiseAbs().maxCoeff() == 0.0,
+                     "concurrent results equal the single-threaded result" ) && passed ;
+
+  return  passed ? 0 : 1 ;
+  } // end main
@@ -0,0 +1,447 @@
+/*
+  sweep.cpp    Jeffery Solheim
+  Headless parameter sweep over the BSCM heat equation, for convergence & design studies.
+
+  Usage:   sweep  specificationFile  [ csv | json ]
+
+  The specification lists the values of each axis of the sweep, one axis per line;
+  '#' begins a comment.  Every combination of values is one case.  For example:
+
+      order        3 5 7            # spline order M
+      N            8 16 32 64       # number of collocation points
+      domain       0:1  0:6.2832    # physical boundaries  xMin:xMax
+      bc           DD DN ND NN      # left & right boundary conditions (see below)
+      knots        uniform graded   # knot spacing (see below); uniform if omitted
+      collocation  midpoint gauss   # collocation strategy (see below); midpoint if omitted
+      diffusivity  0.5 1.0
+      time         0.1              # time at which the solution is compared
+      mode         1                # which eigenfunction is the initial profile
+      threads      0                # 0 selects one thread per hardware thread
+      format       csv              # csv or json (overridden by the command line)
+
+  Boundary condition D forces derivatives 0, 2, 4, ... to be zero at that boundary;
+  N forces derivatives 1, 3, 5, ... to be zero.  The initial profile is an eigenfunction
+  of the second derivative under those conditions, so the exact solution at any time is known.
+  Each case reports the largest error of the spline through its solution, evaluated at the same
+  401 evenly spaced points of [xMin, xMax] whatever the knots & collocation, so that the
+  errors of different strategies can be compared.
+
+  Knots uniform are evenly spaced; knots graded are CollocationStrategy::gaussLegendreKnots,
+  which crowd toward the boundaries with one Gauss-Legendre point in each interval.
+  Collocation midpoint places each point midway between knots, greville at the Greville
+  abscissae of the basis functions (which coincide with the midpoints on uniform knots, but not
+  on graded ones), and gauss at the Gauss-Legendre points.  Gauss points need graded knots:  on
+  uniform knots they stray from the intervals of their basis functions, "B tilde" becomes
+  (nearly) singular, and such a case is skipped, as is any case breaking the Schoenberg-Whitney
+  condition.
+
+  Cases are scheduled over a work-stealing BSCM::ThreadPool.  Cases with the same order,
+  N, domain, knots & collocation share one build of the basis tables, cases which also share boundary conditions
+  share one Spline & one operator matrix, and each case's row is written as soon as it finishes.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "Spline.h"
+#include "ThreadPool.h"
+#include <unsupported/Eigen/MatrixFunctions>
+
+using namespace std ;
+
+// ================================================================================================
+
+// Points of [xMin, xMax], evenly spaced, at which every case's error is measured.
+static const size_t  EVALUATION_POINTS  =  401 ;
+
+struct  SweepSpec
+  {
+  vector<size_t>  orders ;
+  vector<size_t>  Ns ;
+  vector< pair<double,double> >  domains ;
+  vector<string>  bcs ;
+  vector<string>  knots ;
+  vector<string>  collocations ;
+  vector<double>  diffusivities ;
+  double          time ;
+  unsigned int    mode ;
+  size_t          threads ;
+  string          format ;
+  } ; // end SweepSpec struct
+
+struct  SweepCase
+  {
+  size_t  index ;
+  size_t  order ;
+  size_t  N ;
+  double  xMin ;
+  double  xMax ;
+  string  bc ;
+  string  knots ;
+  string  collocation ;
+  double  diffusivity ;
+  } ; // end SweepCase struct
+
+// ================================================================================================
+
+// Builds each keyed object once; later requests for the same key (even while the first build
+// is still running on another thread) receive the same shared object.
+template < typename T >
+class  BuildCache
+  {
+  public :
+    shared_ptr<const T>  get ( const string & key, function< shared_ptr<const T>() > build,
+                               bool & builtHere )
+      {
+      promise< shared_ptr<const T> >        buildPromise ;
+      shared_future< shared_ptr<const T> >  result ;
+        {
+        lock_guard<mutex>  lock ( cacheMutex ) ;
+        typename map< string, shared_future< shared_ptr<const T> > >::iterator  it  =  entries.find ( key ) ;
+        builtHere  =  ( it == entries.end() ) ;
+        if ( builtHere )
+          result  =  entries[key]  =  buildPromise.get_future().share() ;
+        else
+          result  =  it->second ;
+        }
+      // A failed build must still release every waiter, which then rethrows its exception.
+      if ( builtHere )
+        {
+        try
+          {
+          buildPromise.set_value ( build() ) ;
+          }
+        catch ( ... )
+          {
+          buildPromise.set_exception ( current_exception() ) ;
+          }
+        } // end if
+      return  result.get() ;
+      } // end get
+
+  private :
+    mutex  cacheMutex ;
+    map< string, shared_future< shared_ptr<const T> > >  entries ;
+  } ; // end BuildCache class
+
+// ================================================================================================
+
+static bool  parseSpec ( istream & in, SweepSpec & spec )
+  {
+  spec.orders.clear() ; spec.Ns.clear() ; spec.domains.clear() ;
+  spec.bcs.clear() ; spec.knots.clear() ; spec.collocations.clear() ; spec.diffusivities.clear() ;
+  spec.time     =  0.1 ;
+  spec.mode     =  1 ;
+  spec.threads  =  0 ;
+  spec.format   =  "csv" ;
+
+  string  line ;
+  while ( getline ( in, line ) )
+    {
+    line  =  line.substr ( 0, line.find('#') ) ;
+    istringstream  words ( line ) ;
+    string  key, value ;
+    if ( ! ( words >> key ) )
+      continue ;
+    while ( words >> value )
+      {
+      if ( key == "order" )             spec.orders.push_back ( stoul(value) ) ;
+      else if ( key == "N" )            spec.Ns.push_back ( stoul(value) ) ;
+      else if ( key == "bc" )           spec.bcs.push_back ( value ) ;
+      else if ( key == "knots" )        spec.knots.push_back ( value ) ;
+      else if ( key == "collocation" )  spec.collocations.push_back ( value ) ;
+      else if ( key == "diffusivity" )  spec.diffusivities.push_back ( stod(value) ) ;
+      else if ( key == "time" )         spec.time     =  stod ( value ) ;
+      else if ( key == "mode" )         spec.mode     =  stoul ( value ) ;
+      else if ( key == "threads" )      spec.threads  =  stoul ( value ) ;
+      else if ( key == "format" )       spec.format   =  value ;
+      else if ( key == "domain" )
+        {
+        size_t  colon  =  value.find ( ':' ) ;
+        if ( colon == string::npos )
+          {
+          cerr << "domain must be given as xMin:xMax, not " << value << endl ;
+          return  false ;
+          }
+        spec.domains.push_back
+          ( make_pair ( stod(value.substr(0,colon)), stod(value.substr(colon+1)) ) ) ;
+        }
+      else
+        {
+        cerr << "unknown sweep axis " << key << endl ;
+        return  false ;
+        }
+      } // end while value
+    } // end while line
+
+  for ( size_t b = 0 ; b < spec.bcs.size() ; b ++ )
+    if ( (spec.bcs[b].size() != 2) || (spec.bcs[b].find_first_not_of("DN") != string::npos) )
+      {
+      cerr << "bc must be two letters D or N, not " << spec.bcs[b] << endl ;
+      return  false ;
+      }
+  for ( size_t g = 0 ; g < spec.knots.size() ; g ++ )
+    if ( (spec.knots[g] != "uniform") && (spec.knots[g] != "graded") )
+      {
+      cerr << "knots must be uniform or graded, not " << spec.knots[g] << endl ;
+      return  false ;
+      }
+  if ( spec.knots.empty() )
+    spec.knots.push_back ( "uniform" ) ;
+  for ( size_t s = 0 ; s < spec.collocations.size() ; s ++ )
+    if ( (spec.collocations[s] != "midpoint") && (spec.collocations[s] != "greville")
+         && (spec.collocations[s] != "gauss") )
+      {
+      cerr << "collocation must be midpoint, greville or gauss, not " << spec.collocations[s] << endl ;
+      return  false ;
+      }
+  if ( spec.collocations.empty() )
+    spec.collocations.push_back ( "midpoint" ) ;
+  if ( spec.orders.empty() || spec.Ns.empty() || spec.domains.empty()
+       || spec.bcs.empty() || spec.diffusivities.empty() || (spec.mode == 0) )
+    {
+    cerr << "specification needs order, N, domain, bc & diffusivity values, and mode >= 1" << endl ;
+    return  false ;
+    }
+  return  true ;
+  } // end parseSpec
+
+// ================================================================================================
+
+// Uniform knots, with (order - 1) knots beyond each physical boundary.
+static vector<double>  uniformKnots ( size_t order, size_t N, double xMin, double xMax )
+  {
+  vector<double>  knotX ;
+  double  h  =  ( xMax - xMin ) / N ;
+  for ( size_t j = 0 ; j < (N + 2*order - 1) ; j ++ )
+    knotX.push_back ( xMin + ( static_cast<double>(j) - static_cast<double>(order - 1) ) * h ) ;
+  return  knotX ;
+  } // end uniformKnots
+
+// ================================================================================================
+
+// The strategy and the knots named in the specification.
+static BSCM::CollocationStrategy  collocationStrategy ( const string & name )
+  {
+  if ( name == "greville" )
+    return  BSCM::CollocationStrategy::greville ( ) ;
+  if ( name == "gauss" )
+    return  BSCM::CollocationStrategy::gaussLegendre ( ) ;
+  return  BSCM::CollocationStrategy::midpoint ( ) ;
+  } // end collocationStrategy
+
+static vector<double>  collocationKnots ( const string & name, size_t order, size_t N, double xMin, double xMax )
+  {
+  if ( name == "graded" )
+    return  BSCM::CollocationStrategy::gaussLegendreKnots ( order, xMin, xMax, N ) ;
+  return  uniformKnots ( order, N, xMin, xMax ) ;
+  } // end collocationKnots
+
+// ================================================================================================
+
+// Rows for one boundary force derivatives 0, 2, 4, ... (D) or 1, 3, 5, ... (N) to be zero.
+static Eigen::MatrixXi  boundaryConditions ( size_t order, const string & bc )
+  {
+  size_t  rowsPerSide  =  ( order - 1 ) / 2 ;
+  Eigen::MatrixXi  K  =  Eigen::MatrixXi::Zero ( order - 1, order ) ;
+  for ( size_t r = 0 ; r < rowsPerSide ; r ++ )
+    {
+    K ( r,               2*r + ((bc[0] == 'N') ? 1 : 0) )  =  1 ;
+    K ( rowsPerSide + r, 2*r + ((bc[1] == 'N') ? 1 : 0) )  =  1 ;
+    } // end for r loop
+  return  K ;
+  } // end boundaryConditions
+
+// ================================================================================================
+
+// Eigenfunction number `mode` of d^2/dx^2 under boundary conditions bc, and its wavenumber.
+static double  eigenfunction ( const string & bc, unsigned int mode, double xMin, double xMax,
+                               double x, double & wavenumber )
+  {
+  const double  PI  =  4.0 * atan(1.0) ;
+  double  L  =  xMax - xMin ;
+  double  m  =  ( bc[0] == bc[1] ) ? ( mode ) : ( mode - 0.5 ) ;
+  wavenumber  =  m * PI / L ;
+  double  phase  =  wavenumber * ( x - xMin ) ;
+  return  ( bc[0] == 'D' ) ? ( sin(phase) ) : ( cos(phase) ) ;
+  } // end eigenfunction
+
+// ================================================================================================
+
+static double  millisecondsSince ( chrono::steady_clock::time_point start )
+  {
+  return  chrono::duration<double,milli> ( chrono::steady_clock::now() - start ).count() ;
+  } // end millisecondsSince
+
+// ================================================================================================
+
+int main ( int argc, char *argv[] )
+  {
+  if ( argc < 2 )
+    {
+    cerr << "usage:  " << argv[0] << "  specificationFile  [ csv | json ]" << endl ;
+    return  1 ;
+    }
+  ifstream   specFile ( argv[1] ) ;
+  SweepSpec  spec ;
+  if ( ! specFile || ! parseSpec ( specFile, spec ) )
+    {
+    cerr << "cannot read sweep specification " << argv[1] << endl ;
+    return  1 ;
+    }
+  if ( argc >= 3 )
+    spec.format  =  argv[2] ;
+  const bool  json  =  ( spec.format == "json" ) ;
+
+  vector<SweepCase>  cases ;
+  for ( size_t o = 0 ; o < spec.orders.size() ; o ++ )
+    for ( size_t n = 0 ; n < spec.Ns.size() ; n ++ )
+      for ( size_t d = 0 ; d < spec.domains.size() ; d ++ )
+        for ( size_t b = 0 ; b < spec.bcs.size() ; b ++ )
+          for ( size_t g = 0 ; g < spec.knots.size() ; g ++ )
+            for ( size_t s = 0 ; s < spec.collocations.size() ; s ++ )
+              for ( size_t k = 0 ; k < spec.diffusivities.size() ; k ++ )
+                {
+                SweepCase  c  =  { cases.size(), spec.orders[o], spec.Ns[n], spec.domains[d].first,
+                                   spec.domains[d].second, spec.bcs[b], spec.knots[g],
+                                   spec.collocations[s], spec.diffusivities[k] } ;
+                cases.push_back ( c ) ;
+                }
+
+  BuildCache<BSCM::Spline>     basisCache ;
+  BuildCache<BSCM::Spline>     splineCache ;
+  BuildCache<Eigen::MatrixXd>  operatorCache ;
+  mutex  outputMutex ;
+
+  if ( ! json )
+    cout << "case,order,N,xMin,xMax,bc,knots,collocation,diffusivity,time,status,max_error,"
+            "basis_shared,spline_shared,basis_ms,spline_ms,operator_ms,propagate_ms,total_ms" << endl ;
+
+  BSCM::ThreadPool  pool ( spec.threads ) ;
+  for ( size_t c = 0 ; c < cases.size() ; c ++ )
+    pool.submit ( [&, c] ( )
+      {
+      const SweepCase &  sc  =  cases[c] ;
+      chrono::steady_clock::time_point  caseStart  =  chrono::steady_clock::now() ;
+      string  status  =  "ok" ;
+      double  maxError  =  nan("") ;
+      bool    basisBuilt  =  false, splineBuilt  =  false, operatorBuilt  =  false ;
+      double  basisMs  =  0.0, splineMs  =  0.0, operatorMs  =  0.0, propagateMs  =  0.0 ;
+
+      vector<double>  knotX ;
+      if ( (sc.order % 2 == 0) || (sc.order < BSCM::Spline::MIN_ORDER)
+           || (sc.order > BSCM::Spline::MAX_ORDER) || (sc.N == 0) || ! (sc.xMin < sc.xMax) )
+        status  =  "skipped" ;
+      else
+        {
+        knotX  =  collocationKnots ( sc.knots, sc.order, sc.N, sc.xMin, sc.xMax ) ;
+        if ( ((sc.collocation == "gauss") && (sc.knots != "graded"))
+             || ! BSCM::CollocationStrategy::schoenbergWhitney
+                 ( sc.order, knotX, collocationStrategy(sc.collocation).points(sc.order,knotX) ) )
+          status  =  "skipped" ;
+        } // end else
+      if ( status == "ok" )
+        try
+          {
+          ostringstream  basisKey ;
+          basisKey.precision ( 17 ) ;
+          basisKey << sc.order << '|' << sc.N << '|' << sc.xMin << '|' << sc.xMax << '|' << sc.knots
+                   << '|' << sc.collocation ;
+          string  splineKey  =  basisKey.str() + '|' + sc.bc ;
+
+          chrono::steady_clock::time_point  start  =  chrono::steady_clock::now() ;
+          BSCM::SplinePtr  basis  =  basisCache.get ( basisKey.str(), [&] ( )
+            {
+            Eigen::MatrixXi  K  =  boundaryConditions ( sc.order, sc.bc ) ;
+            return  BSCM::Spline::create ( sc.order, knotX, K, collocationStrategy(sc.collocation) ) ;
+            }, basisBuilt ) ;
+          basisMs  =  millisecondsSince ( start ) ;
+
+          start  =  chrono::steady_clock::now() ;
+          BSCM::SplinePtr  spline  =  splineCache.get ( splineKey, [&] ( )
+            {
+            Eigen::MatrixXi  K  =  boundaryConditions ( sc.order, sc.bc ) ;
+            return  ( basis->getK_matrix() == K ) ? ( basis ) : ( BSCM::Spline::create ( *basis, K ) ) ;
+            }, splineBuilt ) ;
+          splineMs  =  millisecondsSince ( start ) ;
+
+          start  =  chrono::steady_clock::now() ;
+          shared_ptr<const Eigen::MatrixXd>  D  =  operatorCache.get ( splineKey, [&] ( )
+            {
+            return  make_shared<const Eigen::MatrixXd> ( spline->operatorMatrix(2) ) ;
+            }, operatorBuilt ) ;
+          operatorMs  =  millisecondsSince ( start ) ;
+
+          start  =  chrono::steady_clock::now() ;
+          const vector<double> &  x  =  spline->getCollocationX() ;
+          Eigen::VectorXd  u0 ( sc.N ) ;
+          double  wavenumber  =  0.0 ;
+          for ( size_t alpha = 0 ; alpha < sc.N ; alpha ++ )
+            u0(alpha)  =  eigenfunction ( sc.bc, spec.mode, sc.xMin, sc.xMax, x[alpha], wavenumber ) ;
+          double  decay  =  exp ( - sc.diffusivity * wavenumber * wavenumber * spec.time ) ;
+          Eigen::MatrixXd  A  =  ( (sc.diffusivity * spec.time) * (*D) ).exp() ;
+          Eigen::VectorXd  f  =  spline->coefficients ( A * u0 ) ;
+          // The same evaluation points for every case, rather than each strategy's own.
+          maxError  =  0.0 ;
+          for ( size_t e = 0 ; e < EVALUATION_POINTS ; e ++ )
+            {
+            double  xe  =  sc.xMin + ( sc.xMax - sc.xMin ) * e / ( EVALUATION_POINTS - 1 ) ;
+            double  exact  =  decay * eigenfunction ( sc.bc, spec.mode, sc.xMin, sc.xMax, xe, wavenumber ) ;
+            double  error  =  fabs ( spline->evaluate ( f, 0, xe ) - exact ) ;
+            if ( ! ( error <= maxError ) )  //  a NaN is kept, and reported as a failure below
+              maxError  =  error ;
+            } // end for e loop
+          propagateMs  =  millisecondsSince ( start ) ;
+          if ( ! std::isfinite ( maxError ) )
+            status  =  "failed" ;
+          } // end try
+        catch ( const exception & )
+          {
+          // Any case sharing a failed build fails too, rather than waiting for it forever.
+          status  =  "failed" ;
+          } // end catch
+
+      double  totalMs  =  millisecondsSince ( caseStart ) ;
+      bool    basisShared   =  ( status != "skipped" ) && ! basisBuilt ;
+      bool    splineShared  =  ( status != "skipped" ) && ! splineBuilt ;
+      ostringstream  error ;  //  max_error at full precision, so that it reads back to the same double
+      error.precision ( std::numeric_limits<double>::max_digits10 ) ;
+      error << maxError ;
+      ostringstream  row ;
+      row.precision ( 10 ) ;
+      if ( json )
+        {
+        row << "{\"case\":" << sc.index << ",\"order\":" << sc.order << ",\"N\":" << sc.N
+            << ",\"xMin\":" << sc.xMin << ",\"xMax\":" << sc.xMax << ",\"bc\":\"" << sc.bc
+            << "\",\"knots\":\"" << sc.knots << "\",\"collocation\":\"" << sc.collocation << "\",\"diffusivity\":" << sc.diffusivity
+            << ",\"time\":" << spec.time << ",\"status\":\"" << status << "\",\"max_error\":" ;
+        if ( std::isfinite ( maxError ) )
+          row << error.str() ;
+        else
+          row << "null" ;
+        row << ",\"basis_shared\":" << ( basisShared ? "true" : "false" )
+            << ",\"spline_shared\":" << ( splineShared ? "true" : "false" )
+            << ",\"basis_ms\":" << basisMs << ",\"spline_ms\":" << splineMs
+            << ",\"operator_ms\":" << operatorMs << ",\"propagate_ms\":" << propagateMs
+            << ",\"total_ms\":" << totalMs << "}" ;
+        } // end if
+      else
+        row << sc.index << ',' << sc.order << ',' << sc.N << ',' << sc.xMin << ',' << sc.xMax
+            << ',' << sc.bc << ',' << sc.knots << ',' << sc.collocation << ',' << sc.diffusivity << ',' << spec.time << ',' << status << ','
+            << error.str() << ',' << basisShared << ',' << splineShared << ',' << basisMs << ','
+            << splineMs << ',' << operatorMs << ',' << propagateMs << ',' << totalMs ;
+
+      lock_guard<mutex>  lock ( outputMutex ) ;
+      cout << row.str() << endl ;
+      } ) ;
+
+  pool.wait ( ) ;
+  return  0 ;
+  } // end main